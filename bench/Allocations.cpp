@@ -0,0 +1,100 @@
+#include "Allocations.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+
+static std::atomic<size_t> allocationCount {0};
+static std::atomic<size_t> allocationBytes {0};
+
+
+//
+// Replacements of the global allocation functions
+//
+
+void *operator new(size_t size) {
+    ++allocationCount;
+    allocationBytes += size;
+
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    ++allocationCount;
+    allocationBytes += size;
+
+    // aligned_alloc needs a size which is a multiple of the alignment
+    const auto align {static_cast<size_t>(alignment)};
+    const auto alignedSize {(std::max<size_t>(size, 1) + align - 1) / align * align};
+    if (void *ptr = std::aligned_alloc(align, alignedSize)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+
+// Older standard libraries do not implement these through the throwing variants
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size, alignment);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t /*size*/) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t /*alignment*/) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t /*alignment*/) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t /*size*/, std::align_val_t /*alignment*/) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, size_t /*size*/, std::align_val_t /*alignment*/) noexcept { std::free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::align_val_t /*alignment*/, const std::nothrow_t &) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t /*alignment*/, const std::nothrow_t &) noexcept { std::free(ptr); }
+
+
+namespace bench {
+
+    AllocationCount getAllocationCount() noexcept {
+        AllocationCount count;
+        count.allocations = allocationCount;
+        count.bytes       = allocationBytes;
+        return count;
+    }
+
+}  // namespace bench
@@ -0,0 +1,51 @@
+#ifndef BENCH_ALLOCATIONS_H
+#define BENCH_ALLOCATIONS_H
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+
+
+namespace bench {
+
+    struct AllocationCount {
+        size_t allocations {0};
+        size_t bytes {0};
+    };
+
+    //
+    // Counts the heap allocations performed through the global operator new, including its aligned and nothrow
+    // variants
+    //
+    AllocationCount getAllocationCount() noexcept;
+
+
+    //
+    // Measures the allocations between construction and destruction and reports them
+    // as per-iteration counters of the benchmark.
+    //
+    class AllocationReporter {
+    public:
+        explicit AllocationReporter(benchmark::State &state) noexcept
+            : mState(state), mStart(getAllocationCount()) {}
+
+        ~AllocationReporter() {
+            const auto end {getAllocationCount()};
+
+            mState.counters["allocs_per_op"] =
+                benchmark::Counter(double(end.allocations - mStart.allocations), benchmark::Counter::kAvgIterations);
+            mState.counters["alloc_bytes_per_op"] =
+                benchmark::Counter(double(end.bytes - mStart.bytes), benchmark::Counter::kAvgIterations);
+        }
+
+        AllocationReporter(const AllocationReporter &) = delete;
+        AllocationReporter &operator=(const AllocationReporter &) = delete;
+
+    private:
+        benchmark::State &mState;
+        AllocationCount mStart;
+    };
+
+}  // namespace bench
+
+#endif
@@ -0,0 +1,222 @@
+#include "Allocations.h"
+#include "Payloads.h"
+
+#include "api/v1/Api.h"
+#include "api/v1/LoopbackTransport.h"
+#include "api/v1/QueueDiff.h"
+#include "api/v1/deserializer.h"
+#include "api/v1/endpoint.h"
+#include "api/v1/sax_deserializer.h"
+
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+
+using json = nlohmann::json;
+using namespace api::v1;
+
+
+//
+// Deserialization of pre-parsed JSON documents
+//
+
+static void BM_DeserializeQueues(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto body = json::parse(bench::makeQueuesBody(trackCount));
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(deserialize<Queues>(body));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+static void BM_DeserializeTracks(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto body = json::parse(bench::makeTracksBody(trackCount));
+    const auto &tracks {body.at("tracks")};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(deserialize<std::vector<BaseTrack>>(tracks));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+
+//
+// Parsing of complete response bodies (DOM vs. SAX)
+//
+
+static void BM_ParseQueuesDom(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto body {bench::makeQueuesBody(trackCount)};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(deserialize<Queues>(json::parse(body)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+    state.SetBytesProcessed(state.iterations() * int64_t(body.size()));
+}
+
+static void BM_ParseQueuesSax(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto body {bench::makeQueuesBody(trackCount)};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(sax::deserialize<Queues>(body));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+    state.SetBytesProcessed(state.iterations() * int64_t(body.size()));
+}
+
+static void BM_ParseTracksDom(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto body {bench::makeTracksBody(trackCount)};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(deserialize<std::vector<BaseTrack>>(json::parse(body).at("tracks")));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+    state.SetBytesProcessed(state.iterations() * int64_t(body.size()));
+}
+
+static void BM_ParseTracksSax(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto body {bench::makeTracksBody(trackCount)};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(sax::deserialize<std::vector<BaseTrack>>(body));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+    state.SetBytesProcessed(state.iterations() * int64_t(body.size()));
+}
+
+
+//
+// URL building, one request URL per track (e.g. when voting for every track)
+//
+
+static void BM_GetRequestEndpoint(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto queues {bench::makeQueues(trackCount)};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            for (const auto &track : queues.normalQueue) {
+                const std::map<std::string, std::string> parameters {
+                    {"pattern", track.title},  //
+                    {"max_entries", "10"}      //
+                };
+                benchmark::DoNotOptimize(getRequestEndpoint("queryTracks", parameters));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+
+//
+// Comparison of two states of the queues, after a track has been played, one added and one voted up
+//
+
+static void BM_DiffQueues(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto from {bench::makeQueues(trackCount)};
+
+    auto to {from};
+    to.normalQueue.erase(std::begin(to.normalQueue));
+
+    auto added {from.normalQueue.front()};
+    added.trackId += "-added";
+    to.normalQueue.push_back(added);
+
+    const auto votedIt {std::next(std::begin(to.normalQueue), std::ptrdiff_t(std::size(to.normalQueue) / 2))};
+    ++votedIt->votes;
+    std::rotate(std::begin(to.normalQueue), votedIt, std::next(votedIt));
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(diffQueues(from, to));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+
+//
+// Whole requests over the loopback transport: building the request, the handler serving a canned body and parsing
+// the response, without any network involved
+//
+
+static std::unique_ptr<Api> makeLoopbackApi(const size_t trackCount) {
+    auto api {std::make_unique<Api>(
+        [handler = bench::makeCannedHandler(trackCount)] { return std::make_unique<LoopbackTransport>(handler); })};
+    api->generateSession(std::nullopt);
+    return api;
+}
+
+static void BM_LoopbackGetQueues(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto api {makeLoopbackApi(trackCount)};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(api->getRecentQueues());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+static void BM_LoopbackQueryTracks(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto api {makeLoopbackApi(trackCount)};
+
+    // Every search has to reach the handler
+    SearchCacheConfig cacheConfig;
+    cacheConfig.capacity = 0;
+    api->setSearchCacheConfig(cacheConfig);
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(api->queryTracks("never gonna", static_cast<unsigned int>(trackCount)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+
+BENCHMARK(BM_DeserializeQueues)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_DeserializeTracks)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_ParseQueuesDom)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_ParseQueuesSax)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_ParseTracksDom)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_ParseTracksSax)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_GetRequestEndpoint)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_DiffQueues)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_LoopbackGetQueues)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK(BM_LoopbackQueryTracks)->RangeMultiplier(10)->Range(10, 100000);
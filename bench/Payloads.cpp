@@ -0,0 +1,127 @@
+#include "Payloads.h"
+
+#include "api/v1/endpoint.h"
+#include "api/v1/serializer.h"
+
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <memory>
+
+
+using json = nlohmann::json;
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static const std::array<const char *, 8> WORDS {"Never", "Gonna", "Give", "You", "Up", "Bohemian", "Rhapsody", "Thunder"};
+
+static std::string makeText(const size_t seed, const size_t words) {
+    std::string text;
+    for (size_t i {0}; i < words; ++i) {
+        if (i != 0) {
+            text += ' ';
+        }
+        text += WORDS[(seed * 7 + i * 3) % std::size(WORDS)];
+    }
+    return text;
+}
+
+static QueueTrack makeQueueTrack(const size_t index) {
+    QueueTrack track;
+    track.trackId  = "spotify:track:" + std::to_string(1000000 + index);
+    track.title    = makeText(index, 1 + index % 5);
+    track.artist   = makeText(index + 1, 1 + index % 3);
+    track.album    = index % 4 == 0 ? std::nullopt : std::optional {makeText(index + 2, 2)};
+    track.duration = int(120000 + (index * 7919) % 240000);
+    track.iconUri  = "https://i.scdn.co/image/" + std::to_string(index);
+    track.addedBy  = "guest" + std::to_string(index % 25);
+    return track;
+}
+
+//
+// Payload generators
+//
+
+namespace bench {
+
+    Queues makeQueues(const size_t trackCount) {
+        Queues queues;
+
+        PlayingTrack playing;
+        static_cast<QueueTrack &>(playing) = makeQueueTrack(trackCount);
+        playing.playing                    = true;
+        playing.playingFor                 = 42000;
+        queues.currentlyPlaying            = playing;
+
+        queues.normalQueue.reserve(trackCount);
+        for (size_t i {0}; i < trackCount; ++i) {
+            NormalQueueTrack track;
+            static_cast<QueueTrack &>(track) = makeQueueTrack(i);
+            track.votes                      = int((i * 31) % 50);
+            track.currentVote                = int(i % 2);
+            queues.normalQueue.push_back(std::move(track));
+        }
+
+        for (size_t i {0}; i < trackCount / 10; ++i) {
+            queues.adminQueue.push_back(makeQueueTrack(trackCount + 1 + i));
+        }
+
+        return queues;
+    }
+
+    std::string makeQueuesBody(const size_t trackCount) {
+        return serialize(makeQueues(trackCount)).dump();
+    }
+
+    std::string makeTracksBody(const size_t trackCount) {
+        std::vector<BaseTrack> tracks;
+        tracks.reserve(trackCount);
+        for (size_t i {0}; i < trackCount; ++i) {
+            tracks.push_back(makeQueueTrack(i));
+        }
+
+        json body;
+        body["tracks"] = serialize(tracks);
+        return body.dump();
+    }
+
+    std::vector<std::string> makeScript(const size_t lineCount) {
+        const std::array<std::string, 6> lines {"print normal 25",
+                                                "vote up",
+                                                "addtrack normal 10",
+                                                "volume down",
+                                                "login jukebox.local 8080 guest secret",
+                                                R"(login  "jukebox  local" 8080 'guest \ one'  sec\ ret)"};
+
+        std::vector<std::string> script;
+        script.reserve(lineCount);
+        for (size_t i {0}; i < lineCount; ++i) {
+            script.push_back(lines[i % std::size(lines)]);
+        }
+        return script;
+    }
+
+    RequestHandler makeCannedHandler(const size_t trackCount) {
+        const auto queuesBodies {std::make_shared<const std::array<std::string, 2>>(
+            std::array<std::string, 2> {makeQueuesBody(trackCount), makeQueuesBody(trackCount + 1)})};
+        const auto tracksBody {std::make_shared<const std::string>(makeTracksBody(trackCount))};
+        const auto queuesServed {std::make_shared<size_t>(0)};
+
+        return [=](const httplib::Request &req, httplib::Response &res) {
+            if (req.path == getRequestEndpoint("generateSession")) {
+                res.set_content(R"({"session_id": "bench"})", "application/json");
+            } else if (req.path == getRequestEndpoint("getCurrentQueues")) {
+                res.set_content((*queuesBodies)[(*queuesServed)++ % 2], "application/json");
+            } else if (req.path == getRequestEndpoint("queryTracks")) {
+                res.set_content(*tracksBody, "application/json");
+            } else {
+                res.status = 404;
+            }
+        };
+    }
+
+}  // namespace bench
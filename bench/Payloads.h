@@ -0,0 +1,36 @@
+#ifndef BENCH_PAYLOADS_H
+#define BENCH_PAYLOADS_H
+
+#include "api/v1/ApiTypes.h"
+#include "api/v1/LoopbackTransport.h"
+
+#include <string>
+#include <vector>
+
+
+namespace bench {
+
+    //
+    // Deterministic synthetic payloads, resembling the responses of a VirtualJukebox server
+    //
+
+    api::v1::Queues makeQueues(const size_t trackCount);
+
+    // Body of a getCurrentQueues response with the given amount of tracks in the normal queue
+    std::string makeQueuesBody(const size_t trackCount);
+
+    // Body of a queryTracks response with the given amount of tracks
+    std::string makeTracksBody(const size_t trackCount);
+
+    // Input lines as they would be piped into the shell
+    std::vector<std::string> makeScript(const size_t lineCount);
+
+    //
+    // Serves sessions, searches and queues the way a server would. Consecutive queues differ in the track count,
+    // so that every response is parsed instead of being reused.
+    //
+    api::v1::RequestHandler makeCannedHandler(const size_t trackCount);
+
+}  // namespace bench
+
+#endif
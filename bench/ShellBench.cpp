@@ -0,0 +1,234 @@
+#include "Allocations.h"
+#include "Payloads.h"
+
+#include "api/v1/Api.h"
+#include "api/v1/Capture.h"
+#include "api/v1/LoopbackTransport.h"
+#include "api/v1/ReplayTransport.h"
+#include "shell/Shell.h"
+#include "shell/ShellCommand.h"
+#include "shell/Tokenizer.h"
+#include "shell/commands/v1/ApiCommands.h"
+#include "shell/commands/v1/QueueRenderer.h"
+#include "shell/commands/v1/QueueView.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+
+using namespace api::v1;
+
+
+//
+// Helper types
+//
+
+// Discards everything written to it, so only the formatting cost is measured
+class NullBuffer : public std::streambuf {
+protected:
+    // Writing EOF must not report a failure
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char * /*s*/, std::streamsize n) override { return n; }
+};
+
+
+//
+// Line tokenization as done by Shell::handleInputs
+//
+
+static void BM_Tokenize(benchmark::State &state) {
+    const auto lineCount {size_t(state.range(0))};
+    const auto script {bench::makeScript(lineCount)};
+
+    size_t bytes {0};
+    for (const auto &line : script) {
+        bytes += line.size() + 1;
+    }
+
+    // Tokenizing works in place, so every line is copied into a reused buffer first
+    std::string buffer;
+    Arguments tokens;
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            for (const auto &line : script) {
+                buffer.assign(line);
+                tokenize(buffer, tokens);
+                benchmark::DoNotOptimize(tokens.data());
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(lineCount));
+    state.SetBytesProcessed(state.iterations() * int64_t(bytes));
+}
+
+
+//
+// Rendering of the queues, printing 'limit' tracks from the beginning or the end of the queue
+//
+
+static commands::v1::QueueRenderer::Page makePage(const size_t trackCount, const size_t limit, const bool lastPage) {
+    commands::v1::QueueRenderer::Page page;
+    page.limit  = limit;
+    page.offset = lastPage ? trackCount - std::min(limit, trackCount) : 0;
+    return page;
+}
+
+static void BM_PrintNormalQueue(benchmark::State &state, const size_t limit, const bool lastPage) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto queues {bench::makeQueues(trackCount)};
+    const auto page {makePage(trackCount, limit, lastPage)};
+
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+    commands::v1::QueueRenderer renderer;
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            renderer.renderNormalQueue(queues, page);
+            renderer.flush(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(std::min(limit, trackCount)));
+}
+
+static void BM_PrintAdminQueue(benchmark::State &state, const size_t limit) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto queues {bench::makeQueues(trackCount)};
+    const auto page {makePage(std::size(queues.adminQueue), limit, false)};
+
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+    commands::v1::QueueRenderer renderer;
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            renderer.renderAdminQueue(queues, page);
+            renderer.flush(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(std::min(limit, std::size(queues.adminQueue))));
+}
+
+
+//
+// Selection of the 'limit' most voted tracks, either from the whole queue or the tracks of one nickname
+//
+
+static void BM_SelectTopVoted(benchmark::State &state, const size_t limit, const bool filtered) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto queues {bench::makeQueues(trackCount)};
+
+    commands::v1::QueueViewOptions options;
+    options.sortKey = commands::v1::QueueSortKey::VOTES;
+    if (filtered) {
+        options.filter.addedBy = queues.normalQueue.front().addedBy;
+    }
+
+    commands::v1::QueueRenderer::Page page;
+    page.limit = limit;
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(commands::v1::selectTracks(queues.normalQueue, options, page));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(trackCount));
+}
+
+
+//
+// A captured session replayed through the whole stack: tokenizing, the commands, the Api, parsing and rendering.
+// The capture is recorded from the canned handler first, so the benchmark does not depend on a server.
+//
+
+static constexpr auto REPLAY_SCRIPT {"login jukebox.local 8080 bench\nprint\nprint normal 25\nprint admin\n"};
+
+static std::unique_ptr<Shell> makeReplayShell() {
+    auto shell {std::make_unique<Shell>()};
+    shell->addCommand("login", std::make_unique<commands::v1::Login>());
+    shell->addCommand("print", std::make_unique<commands::v1::PrintQueues>());
+    return shell;
+}
+
+static std::shared_ptr<CaptureReplay> recordReplayScript(const size_t trackCount) {
+    const auto capturePath {std::filesystem::temp_directory_path() / "virtualjukebox-bench.capture"};
+    const auto capture {CaptureWriter::open(capturePath.string())};
+    if (!capture) {
+        return nullptr;
+    }
+
+    Api::setInstanceCapture(capture);
+    Api::setInstanceTransportFactory(
+        [handler = bench::makeCannedHandler(trackCount)] { return std::make_unique<LoopbackTransport>(handler); });
+
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+    std::istringstream script(REPLAY_SCRIPT);
+    makeReplayShell()->handleBatch(script, out, 1);
+
+    Api::setInstanceCapture(nullptr);
+    Api::setInstanceTransportFactory(nullptr);
+
+    auto exchanges {readCapture(capturePath.string())};
+    std::filesystem::remove(capturePath);
+    return exchanges ? std::make_shared<CaptureReplay>(std::move(exchanges.value()), false) : nullptr;
+}
+
+static void BM_ReplayScript(benchmark::State &state) {
+    const auto trackCount {size_t(state.range(0))};
+    const auto replay {recordReplayScript(trackCount)};
+    if (!replay) {
+        state.SkipWithError("Failed to record the capture");
+        return;
+    }
+
+    Api::setInstanceTransportFactory([replay] { return std::make_unique<ReplayTransport>(replay); });
+    const auto shell {makeReplayShell()};
+
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+    size_t failedCommands {0};
+
+    {
+        bench::AllocationReporter allocations(state);
+        for (auto _ : state) {
+            replay->rewind();
+            std::istringstream script(REPLAY_SCRIPT);
+            failedCommands += std::size(shell->handleBatch(script, out, 1).failedLines);
+        }
+    }
+    Api::setInstanceTransportFactory(nullptr);
+
+    if (failedCommands > 0 || replay->getStats().unmatched > 0) {
+        state.SkipWithError("The replayed script diverged from the capture");
+        return;
+    }
+    state.SetItemsProcessed(int64_t(replay->getStats().replayed));
+}
+
+
+BENCHMARK(BM_Tokenize)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_PrintNormalQueue, first_10, 10, false)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_PrintNormalQueue, last_10, 10, true)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_PrintNormalQueue, all, std::numeric_limits<size_t>::max(), false)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_SelectTopVoted, top_20, 20, false)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_SelectTopVoted, top_20_by_nickname, 20, true)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_PrintAdminQueue, first_10, 10)->RangeMultiplier(10)->Range(10, 100000);
+BENCHMARK_CAPTURE(BM_PrintAdminQueue, all, std::numeric_limits<size_t>::max())->RangeMultiplier(10)->Range(10, 100000);
+
+// Parts of the commands run on the workers of the Api, so only the wall-clock time is meaningful
+BENCHMARK(BM_ReplayScript)->RangeMultiplier(10)->Range(10, 10000)->UseRealTime();
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+//
+// Runs all registered benchmarks. Unless another format is requested, the results are reported
+// as JSON, so they can be collected and compared over time.
+//
+int main(int argc, char **argv) {
+    std::vector<char *> args(argv, argv + argc);
+
+    bool formatGiven {false};
+    for (const auto *arg : args) {
+        formatGiven |= std::strncmp(arg, "--benchmark_format", std::strlen("--benchmark_format")) == 0;
+    }
+
+    std::string jsonFormat {"--benchmark_format=json"};
+    if (!formatGiven) {
+        args.push_back(jsonFormat.data());
+    }
+
+    int argCount {int(args.size())};
+    benchmark::Initialize(&argCount, args.data());
+    if (benchmark::ReportUnrecognizedArguments(argCount, args.data())) {
+        return 1;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
@@ -0,0 +1,277 @@
+/*****************************************************************************/
+/**
+ * @file    LoadGenerator.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a load generator, simulating many guests using the REST API version 1 at once
+ */
+/*****************************************************************************/
+
+#include "LoadGenerator.h"
+
+#include "api/v1/Api.h"
+
+#include <spdlog/spdlog.h>
+
+#include <memory>
+#include <random>
+#include <thread>
+
+
+using namespace api::v1;
+using namespace loadgen;
+
+using Clock = std::chrono::steady_clock;
+
+
+//
+// Helper functions
+//
+
+namespace {
+
+    struct Guest {
+        std::unique_ptr<Api> api;
+
+        // Results of the last queries, used to pick tracks to add and to vote for
+        std::vector<BaseTrack> knownTracks;
+        std::vector<NormalQueueTrack> knownQueue;
+    };
+
+    class GuestThread {
+    public:
+        GuestThread(const LoadConfig &config, const unsigned int seed) : mConfig(config), mRandom(seed) {}
+
+        void addGuest(const size_t guestIndex) {
+            Guest guest;
+            guest.api = std::make_unique<Api>(mConfig.address, mConfig.port);
+
+            // Every search has to reach the server to put load onto it
+            SearchCacheConfig searchCacheConfig;
+            searchCacheConfig.capacity = 0;
+            guest.api->setSearchCacheConfig(searchCacheConfig);
+
+            const auto start {Clock::now()};
+            measure(Endpoint::GENERATE_SESSION, start,
+                    [&] { guest.api->generateSession("guest-" + std::to_string(guestIndex)); });
+
+            // Guests without a session would only produce errors
+            if (guest.api->isSessionGenerated()) {
+                mGuests.push_back(std::move(guest));
+            }
+        }
+
+        size_t getGuestCount() const noexcept { return std::size(mGuests); }
+
+        //
+        // Sends requests every interval (or back to back, if the interval is zero) until the deadline is reached
+        //
+        void run(const Clock::time_point start, const Clock::time_point deadline, const Clock::duration interval) {
+            std::discrete_distribution<unsigned int> operationDistribution(std::cbegin(mConfig.mix),
+                                                                           std::cend(mConfig.mix));
+            if (mGuests.empty()) {
+                return;
+            }
+
+            auto scheduled {start};
+            for (size_t requestIndex {0};; ++requestIndex) {
+                if (interval.count() > 0) {
+                    scheduled = start + interval * int64_t(requestIndex);
+                    std::this_thread::sleep_until(scheduled);
+                } else {
+                    scheduled = Clock::now();
+                }
+
+                // Requests still scheduled when the server fell behind are dropped at the deadline
+                if (scheduled >= deadline || Clock::now() >= deadline) {
+                    break;
+                }
+
+                auto &guest {mGuests[requestIndex % std::size(mGuests)]};
+                switch (operationDistribution(mRandom)) {
+                case 0:
+                    queryTracks(guest, scheduled);
+                    break;
+                case 1:
+                    addTrack(guest, scheduled);
+                    break;
+                case 2:
+                    voteTrack(guest, scheduled);
+                    break;
+                default:
+                    getCurrentQueues(guest, scheduled);
+                    break;
+                }
+            }
+        }
+
+        const std::array<EndpointResult, ENDPOINT_COUNT> &getResults() const noexcept { return mResults; }
+
+    private:
+        template<typename F>
+        void measure(const Endpoint endpoint, const Clock::time_point scheduled, F &&request) {
+            auto &result {mResults[size_t(endpoint)]};
+            try {
+                request();
+            } catch (const std::exception &e) {
+                if (result.errors++ == 0) {
+                    result.firstError = e.what();
+                }
+            }
+
+            const auto latency {std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - scheduled)};
+            result.latency.record(uint64_t(std::max<std::chrono::microseconds::rep>(latency.count(), 0)));
+        }
+
+        void queryTracks(Guest &guest, const Clock::time_point scheduled) {
+            std::uniform_int_distribution<size_t> patternDistribution(0, std::size(mConfig.patterns) - 1);
+            const auto &pattern {mConfig.patterns[patternDistribution(mRandom)]};
+
+            measure(Endpoint::QUERY_TRACKS, scheduled, [&] {
+                auto tracks {guest.api->queryTracks(pattern, 10)};
+                if (!tracks.empty()) {
+                    guest.knownTracks = std::move(tracks);
+                }
+            });
+        }
+
+        void addTrack(Guest &guest, const Clock::time_point scheduled) {
+            // A guest has to search before adding something
+            if (guest.knownTracks.empty()) {
+                queryTracks(guest, scheduled);
+                return;
+            }
+
+            std::uniform_int_distribution<size_t> trackDistribution(0, std::size(guest.knownTracks) - 1);
+            const auto &track {guest.knownTracks[trackDistribution(mRandom)]};
+
+            measure(Endpoint::ADD_TRACK, scheduled, [&] { guest.api->addTrack(track); });
+        }
+
+        void voteTrack(Guest &guest, const Clock::time_point scheduled) {
+            // A guest has to see the queue before voting
+            if (guest.knownQueue.empty()) {
+                getCurrentQueues(guest, scheduled);
+                return;
+            }
+
+            std::uniform_int_distribution<size_t> trackDistribution(0, std::size(guest.knownQueue) - 1);
+            const auto &track {guest.knownQueue[trackDistribution(mRandom)]};
+            const auto vote {std::bernoulli_distribution(0.8)(mRandom) ? Vote::UP_VOTE : Vote::DOWN_VOTE};
+
+            measure(Endpoint::VOTE_TRACK, scheduled, [&] { guest.api->voteTrack(track, vote); });
+        }
+
+        void getCurrentQueues(Guest &guest, const Clock::time_point scheduled) {
+            measure(Endpoint::GET_CURRENT_QUEUES, scheduled,
+                    [&] { guest.knownQueue = guest.api->getCurrentQueues().normalQueue; });
+        }
+
+    private:
+        const LoadConfig &mConfig;
+        std::mt19937 mRandom;
+
+        std::vector<Guest> mGuests;
+        std::array<EndpointResult, ENDPOINT_COUNT> mResults;
+    };
+
+}  // namespace
+
+
+namespace loadgen {
+
+    std::string to_string(const Endpoint endpoint) {
+        switch (endpoint) {
+        case Endpoint::GENERATE_SESSION:
+            return "generateSession";
+        case Endpoint::QUERY_TRACKS:
+            return "queryTracks";
+        case Endpoint::ADD_TRACK:
+            return "addTrack";
+        case Endpoint::VOTE_TRACK:
+            return "voteTrack";
+        case Endpoint::GET_CURRENT_QUEUES:
+            return "getCurrentQueues";
+
+        default:
+            return "unknown";
+        }
+    }
+
+
+    LoadResult runLoad(const LoadConfig &config) {
+        const auto threadCount {std::max<size_t>(std::min(config.threads, config.guests), 1)};
+
+        std::vector<std::unique_ptr<GuestThread>> guestThreads;
+        for (size_t i {0}; i < threadCount; ++i) {
+            guestThreads.push_back(std::make_unique<GuestThread>(config, config.seed + unsigned(i)));
+        }
+
+
+        //
+        // Setup: every thread creates the sessions of its guests
+        //
+
+        spdlog::info("Creating {} sessions on {} threads", config.guests, threadCount);
+        {
+            std::vector<std::thread> threads;
+            for (size_t i {0}; i < threadCount; ++i) {
+                threads.emplace_back([&config, &guestThreads, threadCount, i] {
+                    for (size_t guestIndex {i}; guestIndex < config.guests; guestIndex += threadCount) {
+                        guestThreads[i]->addGuest(guestIndex);
+                    }
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        }
+
+
+        //
+        // Load: every thread sends its share of the target rate, starting at the same time
+        //
+
+        spdlog::info("Running for {}s", config.duration.count());
+
+        const auto start {Clock::now() + std::chrono::milliseconds(100)};
+        const auto deadline {start + config.duration};
+        {
+            std::vector<std::thread> threads;
+            for (auto &guestThread : guestThreads) {
+                Clock::duration interval {0};
+                if (config.requestRate > 0.0 && guestThread->getGuestCount() > 0) {
+                    const auto threadRate {config.requestRate * double(guestThread->getGuestCount())
+                                           / double(config.guests)};
+                    interval         = std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(1.0 / threadRate));
+                }
+
+                threads.emplace_back([&guestThread, start, deadline, interval] {
+                    guestThread->run(start, deadline, interval);
+                });
+            }
+            for (auto &thread : threads) {
+                thread.join();
+            }
+        }
+
+        LoadResult result;
+        result.elapsed = std::max(Clock::now() - start, Clock::duration(0));
+        result.threads = threadCount;
+
+        for (const auto &guestThread : guestThreads) {
+            const auto &threadResults {guestThread->getResults()};
+            for (size_t i {0}; i < ENDPOINT_COUNT; ++i) {
+                auto &endpointResult {result.endpoints[i]};
+                endpointResult.latency.merge(threadResults[i].latency);
+                endpointResult.errors += threadResults[i].errors;
+                if (endpointResult.firstError.empty()) {
+                    endpointResult.firstError = threadResults[i].firstError;
+                }
+            }
+        }
+
+        return result;
+    }
+
+}  // namespace loadgen
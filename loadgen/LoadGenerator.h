@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/**
+ * @file    LoadGenerator.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a load generator, simulating many guests using the REST API version 1 at once
+ */
+/*****************************************************************************/
+
+#ifndef LOADGEN_LOAD_GENERATOR_H
+#define LOADGEN_LOAD_GENERATOR_H
+
+#include "utils/Histogram.h"
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+
+
+namespace loadgen {
+
+    enum class Endpoint { GENERATE_SESSION, QUERY_TRACKS, ADD_TRACK, VOTE_TRACK, GET_CURRENT_QUEUES };
+
+    constexpr size_t ENDPOINT_COUNT {5};
+
+    std::string to_string(const Endpoint endpoint);
+
+
+    struct LoadConfig {
+        std::string address;
+        unsigned int port;
+
+        // Every guest owns a session and a connection, guests are distributed over the threads
+        size_t guests {10};
+        size_t threads {4};
+
+        // Requests per second over all guests, 0 sends the next request as soon as the last one returned
+        double requestRate {20.0};
+        std::chrono::seconds duration {10};
+
+        // Relative weights of queryTracks, addTrack, voteTrack and getCurrentQueues
+        std::array<unsigned int, 4> mix {2, 1, 4, 10};
+        std::vector<std::string> patterns {"the", "love", "you", "night", "up", "thunder"};
+
+        unsigned int seed {42};
+    };
+
+    struct EndpointResult {
+        // Latency in microseconds, measured from the time the request was scheduled
+        sk::Histogram latency;
+        size_t errors {0};
+        std::string firstError;
+    };
+
+    struct LoadResult {
+        std::chrono::duration<double> elapsed {0};
+
+        // Never more than there are guests, but at least one
+        size_t threads {0};
+        std::array<EndpointResult, ENDPOINT_COUNT> endpoints;
+    };
+
+
+    //
+    // Creates one session per guest and runs the configured request mix for the configured duration.
+    // Failing requests are counted per endpoint, they do not stop the run.
+    //
+    LoadResult runLoad(const LoadConfig &config);
+
+}  // namespace loadgen
+
+#endif
@@ -0,0 +1,135 @@
+#include "LoadGenerator.h"
+
+#include <docopt/docopt.h>
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include <iostream>
+#include <sstream>
+
+
+static constexpr auto USAGE {
+    R"(VirtualJukebox load generator.
+
+Simulates guests, each with its own session, sending a mix of requests to a VirtualJukebox server.
+
+Usage:
+  virtualjukebox-loadgen <address> <port> [options]
+  virtualjukebox-loadgen (-h | --help)
+
+Options:
+  -h --help             Show this screen.
+  --guests=<count>      Number of simulated guests [default: 10].
+  --threads=<count>     Number of threads sending requests [default: 4].
+  --rate=<rps>          Target requests per second over all guests, 0 for no limit [default: 20].
+  --duration=<s>        Duration of the measurement in seconds [default: 10].
+  --mix=<weights>       Weights of queryTracks,addTrack,voteTrack,getCurrentQueues [default: 2,1,4,10].
+  --patterns=<list>     Comma separated search patterns [default: the,love,you,night,up,thunder].
+  --seed=<seed>         Seed for the choice of requests, patterns, tracks and votes [default: 42].
+  -v --verbose          Log progress and requests.
+)"};
+
+
+//
+// Helper functions
+//
+
+static std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::stringstream listStream(list);
+    std::string item;
+    while (std::getline(listStream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+static void printReport(std::ostream &out, const loadgen::LoadConfig &config, const loadgen::LoadResult &result) {
+    size_t requests {0};
+    size_t errors {0};
+    for (size_t i {1}; i < loadgen::ENDPOINT_COUNT; ++i) {
+        requests += result.endpoints[i].latency.getCount();
+        errors += result.endpoints[i].errors;
+    }
+
+    const auto elapsed {result.elapsed.count()};
+    out << fmt::format("Guests    : {} on {} threads", config.guests, result.threads) << std::endl;
+    out << fmt::format("Requests  : {} in {:.2f}s, {} failed", requests, elapsed, errors) << std::endl;
+    out << fmt::format("Throughput: {:.1f} requests/s (target {})", elapsed > 0.0 ? double(requests) / elapsed : 0.0,
+                       config.requestRate > 0.0 ? fmt::format("{:.1f}", config.requestRate) : "unlimited")
+        << std::endl
+        << std::endl;
+
+    // Latencies are recorded in microseconds and printed in milliseconds
+    const auto ms {[](const uint64_t us) { return double(us) / 1000.0; }};
+
+    out << fmt::format("{:<18} {:>8} {:>8} {:>10} {:>10} {:>10} {:>10}", "Endpoint", "Count", "Errors", "p50 ms",
+                       "p95 ms", "p99 ms", "max ms")
+        << std::endl;
+    for (size_t i {0}; i < loadgen::ENDPOINT_COUNT; ++i) {
+        const auto &endpoint {result.endpoints[i]};
+        const auto &latency {endpoint.latency};
+        out << fmt::format("{:<18} {:>8} {:>8} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}",
+                           to_string(static_cast<loadgen::Endpoint>(i)), latency.getCount(), endpoint.errors,
+                           ms(latency.getPercentile(50)), ms(latency.getPercentile(95)), ms(latency.getPercentile(99)),
+                           ms(latency.getMax()))
+            << std::endl;
+    }
+
+    for (size_t i {0}; i < loadgen::ENDPOINT_COUNT; ++i) {
+        const auto &endpoint {result.endpoints[i]};
+        if (endpoint.errors > 0) {
+            out << std::endl
+                << fmt::format("First error of {}: {}", to_string(static_cast<loadgen::Endpoint>(i)),
+                               endpoint.firstError);
+        }
+    }
+    out << std::endl;
+}
+
+
+int main(int argc, const char **argv) {
+    const auto args {docopt::docopt(USAGE, {std::next(argv), std::next(argv, argc)}, true)};
+
+    loadgen::LoadConfig config;
+    try {
+        config.address     = args.at("<address>").asString();
+        config.port        = static_cast<unsigned int>(std::stoul(args.at("<port>").asString()));
+        config.guests      = std::stoul(args.at("--guests").asString());
+        config.threads     = std::stoul(args.at("--threads").asString());
+        config.requestRate = std::stod(args.at("--rate").asString());
+        config.duration    = std::chrono::seconds(std::stol(args.at("--duration").asString()));
+        config.patterns    = splitList(args.at("--patterns").asString());
+        config.seed        = static_cast<unsigned int>(std::stoul(args.at("--seed").asString()));
+
+        const auto weights {splitList(args.at("--mix").asString())};
+        if (std::size(weights) != std::size(config.mix)) {
+            throw std::invalid_argument("--mix");
+        }
+        unsigned int weightSum {0};
+        for (size_t i {0}; i < std::size(weights); ++i) {
+            config.mix[i] = static_cast<unsigned int>(std::stoul(weights[i]));
+            weightSum += config.mix[i];
+        }
+
+        if (config.guests == 0 || weightSum == 0 || config.patterns.empty() || config.requestRate < 0.0) {
+            throw std::invalid_argument("out of range");
+        }
+    } catch (const std::logic_error &) {
+        std::cerr << "Invalid option value" << std::endl << std::endl << USAGE;
+        return 1;
+    }
+
+    spdlog::set_level(args.at("--verbose").asBool() ? spdlog::level::debug : spdlog::level::warn);
+
+    const auto result {loadgen::runLoad(config)};
+    printReport(std::cout, config, result);
+
+    // Signal failed requests to calling scripts
+    for (const auto &endpoint : result.endpoints) {
+        if (endpoint.errors > 0) {
+            return 2;
+        }
+    }
+    return 0;
+}
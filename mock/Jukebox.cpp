@@ -0,0 +1,544 @@
+/*****************************************************************************/
+/**
+ * @file    Jukebox.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of an in-memory VirtualJukebox, serving the REST API version 1 for local measurements
+ */
+/*****************************************************************************/
+
+#include "Jukebox.h"
+
+#include "api/v1/serializer.h"
+#include "utils/http-status.h"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <map>
+#include <thread>
+#include <utility>
+
+
+using json = nlohmann::json;
+using namespace api::v1;
+using namespace mock;
+
+
+//
+// Helper functions
+//
+
+namespace {
+
+    //
+    // Thrown by endpoint implementations, answered with the given status code
+    //
+    struct RequestError {
+        int status;
+        std::string message;
+    };
+
+    const std::array<const char *, 16> WORDS {"Never",    "Gonna",   "Give",   "You",    "Up",   "Bohemian",
+                                              "Rhapsody", "Thunder", "Stairs", "Heaven", "Hotel", "California",
+                                              "Smells",   "Like",    "Teen",   "Spirit"};
+
+    std::string makeText(std::mt19937 &random, const size_t words) {
+        std::uniform_int_distribution<size_t> wordDistribution(0, std::size(WORDS) - 1);
+
+        std::string text;
+        for (size_t i {0}; i < words; ++i) {
+            if (i != 0) {
+                text += ' ';
+            }
+            text += WORDS[wordDistribution(random)];
+        }
+        return text;
+    }
+
+    BaseTrack makeTrack(std::mt19937 &random, const size_t index) {
+        std::uniform_int_distribution<size_t> wordsDistribution(1, 4);
+        std::uniform_int_distribution<int> durationDistribution(90000, 420000);
+
+        BaseTrack track;
+        track.trackId  = "mock:track:" + std::to_string(index);
+        track.title    = makeText(random, wordsDistribution(random));
+        track.artist   = makeText(random, wordsDistribution(random));
+        track.album    = index % 4 == 0 ? std::nullopt : std::optional {makeText(random, wordsDistribution(random))};
+        track.duration = durationDistribution(random);
+        track.iconUri  = "https://mock.local/icons/" + std::to_string(index) + ".png";
+        return track;
+    }
+
+    QueueTrack makeQueueTrack(const BaseTrack &track, const std::string &addedBy) {
+        QueueTrack queueTrack;
+        static_cast<BaseTrack &>(queueTrack) = track;
+        queueTrack.addedBy                   = addedBy;
+        return queueTrack;
+    }
+
+    bool containsIgnoreCase(const std::string &haystack, const std::string &needle) {
+        const auto it {std::search(std::cbegin(haystack), std::cend(haystack), std::cbegin(needle), std::cend(needle),
+                                   [](const char a, const char b) {
+                                       return std::tolower(static_cast<unsigned char>(a))
+                                              == std::tolower(static_cast<unsigned char>(b));
+                                   })};
+        return it != std::cend(haystack);
+    }
+
+    json parseBody(const httplib::Request &req) {
+        try {
+            return json::parse(req.body);
+        } catch (const json::parse_error &) {
+            throw RequestError {400, "Request body is no valid JSON"};
+        }
+    }
+
+    template<typename T>
+    T getField(const json &body, const char *const field) {
+        try {
+            return body.at(field).get<T>();
+        } catch (const json::exception &) {
+            throw RequestError {400, fmt::format("Missing or invalid field '{}'", field)};
+        }
+    }
+
+    std::string getParameter(const httplib::Request &req, const char *const parameter) {
+        if (!req.has_param(parameter)) {
+            throw RequestError {400, fmt::format("Missing parameter '{}'", parameter)};
+        }
+        return req.get_param_value(parameter);
+    }
+
+    QueueType getQueueType(const json &body) {
+        try {
+            return from_string<QueueType>(getField<std::string>(body, "queue_type"));
+        } catch (const APIException &) {
+            throw RequestError {400, "Unknown queue type"};
+        }
+    }
+
+    void setJsonContent(httplib::Response &res, const int status, const json &body) {
+        res.status = status;
+        res.set_content(body.dump(), "application/json");
+    }
+
+    int countVotes(const int baseVotes, const std::unordered_map<std::string, int> &votes) {
+        return baseVotes + int(std::count_if(std::cbegin(votes), std::cend(votes),
+                                             [](const auto &vote) { return vote.second != 0; }));
+    }
+
+}  // namespace
+
+
+//
+// Constructors
+//
+
+Jukebox::Jukebox(const JukeboxConfig &config)
+    : mConfig(config), mRandom(config.seed), mLastUpdate(std::chrono::steady_clock::now()) {
+
+    // Every queued track has to be known to the library
+    const auto librarySize {std::max(mConfig.librarySize, mConfig.normalQueueSize + mConfig.adminQueueSize + 1)};
+
+    mLibrary.reserve(librarySize);
+    for (size_t i {0}; i < librarySize; ++i) {
+        mLibrary.push_back(makeTrack(mRandom, i));
+        mLibraryIndex.emplace(mLibrary.back().trackId, i);
+    }
+
+    std::uniform_int_distribution<int> votesDistribution(0, 20);
+
+    size_t nextTrack {0};
+    mCurrentlyPlaying = makeQueueTrack(mLibrary[nextTrack++], "mock");
+    for (size_t i {0}; i < mConfig.normalQueueSize; ++i) {
+        mNormalQueue.push_back({makeQueueTrack(mLibrary[nextTrack++], "guest"), votesDistribution(mRandom), {}});
+    }
+    for (size_t i {0}; i < mConfig.adminQueueSize; ++i) {
+        mAdminQueue.push_back(makeQueueTrack(mLibrary[nextTrack++], "admin"));
+    }
+    sortNormalQueue();
+
+    spdlog::debug("Jukebox::Jukebox: {} tracks, {} in normal queue, {} in admin queue", std::size(mLibrary),
+                  std::size(mNormalQueue), std::size(mAdminQueue));
+}
+
+
+//
+// Request handling
+//
+
+void Jukebox::handle(const httplib::Request &req, httplib::Response &res) {
+    static const std::map<std::pair<std::string, std::string>, Endpoint> ROUTES {
+        {{"POST", "/api/v1/generateSession"}, &Jukebox::generateSession},   //
+        {{"GET", "/api/v1/queryTracks"}, &Jukebox::queryTracks},            //
+        {{"GET", "/api/v1/getCurrentQueues"}, &Jukebox::getCurrentQueues},  //
+        {{"POST", "/api/v1/addTrackToQueue"}, &Jukebox::addTrackToQueue},   //
+        {{"PUT", "/api/v1/voteTrack"}, &Jukebox::voteTrack},                //
+        {{"PUT", "/api/v1/controlPlayer"}, &Jukebox::controlPlayer},        //
+        {{"PUT", "/api/v1/moveTrack"}, &Jukebox::moveTrack},                //
+        {{"DELETE", "/api/v1/removeTrack"}, &Jukebox::removeTrack}          //
+    };
+
+    ++mRequests;
+    spdlog::debug("Jukebox::handle: {} {}", req.method, req.path);
+
+    if (injectFaults(res)) {
+        return;
+    }
+
+    const auto routeIt {ROUTES.find({req.method, req.path})};
+    if (routeIt == ROUTES.cend()) {
+        setJsonContent(res, 404, {{"error", "Unknown endpoint"}});
+        return;
+    }
+
+    try {
+        std::lock_guard<std::mutex> lock(mStateMutex);
+        updatePlayback();
+        (this->*(routeIt->second))(req, res);
+    } catch (const RequestError &error) {
+        spdlog::debug("Jukebox::handle: {} {} failed with {}: {}", req.method, req.path, error.status, error.message);
+        setJsonContent(res, error.status, {{"error", error.message}});
+    }
+}
+
+JukeboxStats Jukebox::getStats() const noexcept {
+    JukeboxStats stats;
+    stats.requests       = mRequests;
+    stats.injectedErrors = mInjectedErrors;
+    stats.notModified    = mNotModified;
+    return stats;
+}
+
+
+//
+// Endpoint implementations
+//
+
+void Jukebox::generateSession(const httplib::Request &req, httplib::Response &res) {
+    // The client sends 'null' as body if neither nickname nor password are given
+    const auto body = req.body.empty() ? json::object() : parseBody(req);
+
+    Session session {"", false};
+    if (body.is_object() && body.contains("password")) {
+        if (getField<std::string>(body, "password") != mConfig.adminPassword) {
+            throw RequestError {static_cast<int>(sk::HttpStatus::UNAUTHORIZED), "Invalid admin password"};
+        }
+        session.isAdmin = true;
+    }
+    if (body.is_object() && body.contains("nickname")) {
+        session.nickname = getField<std::string>(body, "nickname");
+    }
+
+    const auto sessionId {"mock-session-" + std::to_string(mNextSessionId++)};
+    mSessions.emplace(sessionId, std::move(session));
+
+    setJsonContent(res, 200, {{"session_id", sessionId}});
+}
+
+void Jukebox::queryTracks(const httplib::Request &req, httplib::Response &res) {
+    const auto pattern {getParameter(req, "pattern")};
+
+    size_t maxEntries {0};
+    try {
+        maxEntries = std::stoul(getParameter(req, "max_entries"));
+    } catch (const std::logic_error &) {
+        throw RequestError {400, "Invalid parameter 'max_entries'"};
+    }
+
+    std::vector<BaseTrack> tracks;
+    for (const auto &track : mLibrary) {
+        if (std::size(tracks) >= maxEntries) {
+            break;
+        }
+        if (containsIgnoreCase(track.title, pattern) || containsIgnoreCase(track.artist.value_or(""), pattern) ||
+            containsIgnoreCase(track.album.value_or(""), pattern)) {
+            tracks.push_back(track);
+        }
+    }
+
+    setJsonContent(res, 200, {{"tracks", serialize(tracks)}});
+}
+
+void Jukebox::getCurrentQueues(const httplib::Request &req, httplib::Response &res) {
+    const auto sessionId {getParameter(req, "session_id")};
+    getSession(sessionId);
+
+    Queues queues;
+    if (mCurrentlyPlaying) {
+        PlayingTrack playing;
+        static_cast<QueueTrack &>(playing) = mCurrentlyPlaying.value();
+        playing.playing                    = mPlaying;
+        playing.playingFor                 = int(mPlayedFor.count());
+        queues.currentlyPlaying            = std::move(playing);
+    }
+
+    queues.normalQueue.reserve(std::size(mNormalQueue));
+    for (const auto &entry : mNormalQueue) {
+        NormalQueueTrack track;
+        static_cast<QueueTrack &>(track) = entry.track;
+        track.votes                      = countVotes(entry.baseVotes, entry.votes);
+
+        const auto voteIt {entry.votes.find(sessionId)};
+        track.currentVote = voteIt == entry.votes.cend() ? 0 : voteIt->second;
+
+        queues.normalQueue.push_back(std::move(track));
+    }
+    queues.adminQueue = mAdminQueue;
+
+    // No braces: the json would be wrapped into an array
+    auto content = serialize(queues);
+    const auto body {content.dump()};
+    if (mConfig.etags) {
+        // Derived from the content without the progress of the playing track, which changes on every request
+        if (queues.currentlyPlaying) {
+            content["currently_playing"].erase("playing_for");
+        }
+        const auto etag {'"' + std::to_string(std::hash<std::string>()(content.dump())) + '"'};
+        res.set_header("ETag", etag.c_str());
+
+        if (req.get_header_value("If-None-Match") == etag) {
+            ++mNotModified;
+            res.status = 304;
+            if (mConfig.notModifiedLength) {
+                res.set_header("Content-Length", std::to_string(std::size(body)));
+            }
+            return;
+        }
+    }
+
+    res.status = 200;
+    res.set_content(body, "application/json");
+}
+
+void Jukebox::addTrackToQueue(const httplib::Request &req, httplib::Response &res) {
+    const auto body = parseBody(req);
+    const auto &session {getSession(getField<std::string>(body, "session_id"))};
+    const auto &track {getLibraryTrack(getField<std::string>(body, "track_id"))};
+    const auto queueType {getQueueType(body)};
+
+    const auto inNormalQueue {std::any_of(std::cbegin(mNormalQueue), std::cend(mNormalQueue),
+                                          [&](const auto &entry) { return entry.track.trackId == track.trackId; })};
+    const auto inAdminQueue {std::any_of(std::cbegin(mAdminQueue), std::cend(mAdminQueue),
+                                         [&](const auto &queued) { return queued.trackId == track.trackId; })};
+    if (inNormalQueue || inAdminQueue) {
+        throw RequestError {400, "Track is already queued"};
+    }
+
+    const auto addedBy {session.nickname.empty() ? std::string("anonymous") : session.nickname};
+    if (queueType == QueueType::ADMIN) {
+        if (!session.isAdmin) {
+            throw RequestError {static_cast<int>(sk::HttpStatus::UNAUTHORIZED), "Admin session required"};
+        }
+        mAdminQueue.push_back(makeQueueTrack(track, addedBy));
+    } else {
+        mNormalQueue.push_back({makeQueueTrack(track, addedBy), 0, {}});
+        sortNormalQueue();
+    }
+
+    setJsonContent(res, 200, json::object());
+}
+
+void Jukebox::voteTrack(const httplib::Request &req, httplib::Response &res) {
+    const auto body = parseBody(req);
+    const auto sessionId {getField<std::string>(body, "session_id")};
+    getSession(sessionId);
+    const auto trackId {getField<std::string>(body, "track_id")};
+    const auto vote {getField<int>(body, "vote")};
+
+    const auto entryIt {std::find_if(std::begin(mNormalQueue), std::end(mNormalQueue),
+                                     [&](const auto &entry) { return entry.track.trackId == trackId; })};
+    if (entryIt == std::end(mNormalQueue)) {
+        throw RequestError {404, "Track is not in the normal queue"};
+    }
+
+    entryIt->votes[sessionId] = vote != 0 ? 1 : 0;
+    sortNormalQueue();
+
+    setJsonContent(res, 200, json::object());
+}
+
+void Jukebox::controlPlayer(const httplib::Request &req, httplib::Response &res) {
+    const auto body = parseBody(req);
+    getAdminSession(getField<std::string>(body, "session_id"));
+
+    PlayerAction action;
+    try {
+        action = from_string<PlayerAction>(getField<std::string>(body, "player_action"));
+    } catch (const APIException &) {
+        throw RequestError {400, "Unknown player action"};
+    }
+
+    switch (action) {
+    case PlayerAction::PLAY:
+        mPlaying = true;
+        break;
+    case PlayerAction::PAUSE:
+        mPlaying = false;
+        break;
+    case PlayerAction::SKIP:
+        playNextTrack();
+        break;
+    case PlayerAction::VOLUME_UP:
+        mVolume = std::min(mVolume + 10, 100);
+        break;
+    case PlayerAction::VOLUME_DOWN:
+        mVolume = std::max(mVolume - 10, 0);
+        break;
+    }
+
+    setJsonContent(res, 200, json::object());
+}
+
+void Jukebox::moveTrack(const httplib::Request &req, httplib::Response &res) {
+    const auto body = parseBody(req);
+    getAdminSession(getField<std::string>(body, "session_id"));
+    const auto trackId {getField<std::string>(body, "track_id")};
+    const auto queueType {getQueueType(body)};
+
+    const auto normalIt {std::find_if(std::begin(mNormalQueue), std::end(mNormalQueue),
+                                      [&](const auto &entry) { return entry.track.trackId == trackId; })};
+    const auto adminIt {std::find_if(std::begin(mAdminQueue), std::end(mAdminQueue),
+                                     [&](const auto &queued) { return queued.trackId == trackId; })};
+
+    if (queueType == QueueType::ADMIN && normalIt != std::end(mNormalQueue)) {
+        mAdminQueue.push_back(std::move(normalIt->track));
+        mNormalQueue.erase(normalIt);
+    } else if (queueType == QueueType::NORMAL && adminIt != std::end(mAdminQueue)) {
+        mNormalQueue.push_back({std::move(*adminIt), 0, {}});
+        mAdminQueue.erase(adminIt);
+        sortNormalQueue();
+    } else if (normalIt == std::end(mNormalQueue) && adminIt == std::end(mAdminQueue)) {
+        throw RequestError {404, "Track is not queued"};
+    }
+
+    setJsonContent(res, 200, json::object());
+}
+
+void Jukebox::removeTrack(const httplib::Request &req, httplib::Response &res) {
+    const auto body = parseBody(req);
+    getAdminSession(getField<std::string>(body, "session_id"));
+    const auto trackId {getField<std::string>(body, "track_id")};
+
+    const auto normalIt {std::find_if(std::begin(mNormalQueue), std::end(mNormalQueue),
+                                      [&](const auto &entry) { return entry.track.trackId == trackId; })};
+    const auto adminIt {std::find_if(std::begin(mAdminQueue), std::end(mAdminQueue),
+                                     [&](const auto &queued) { return queued.trackId == trackId; })};
+
+    if (normalIt != std::end(mNormalQueue)) {
+        mNormalQueue.erase(normalIt);
+    } else if (adminIt != std::end(mAdminQueue)) {
+        mAdminQueue.erase(adminIt);
+    } else {
+        throw RequestError {404, "Track is not queued"};
+    }
+
+    setJsonContent(res, 200, json::object());
+}
+
+
+//
+// Helpers
+//
+
+bool Jukebox::injectFaults(httplib::Response &res) {
+    auto delay {mConfig.latency};
+    bool injectError {false};
+    {
+        std::lock_guard<std::mutex> lock(mRandomMutex);
+        if (mConfig.latencyJitter.count() > 0) {
+            std::uniform_int_distribution<std::chrono::milliseconds::rep> jitterDistribution(
+                0, mConfig.latencyJitter.count());
+            delay += std::chrono::milliseconds(jitterDistribution(mRandom));
+        }
+        if (mConfig.errorRate > 0.0) {
+            injectError = std::bernoulli_distribution(std::min(mConfig.errorRate, 1.0))(mRandom);
+        }
+    }
+
+    // Sleep without holding any lock, so concurrent requests overlap like they would on a real server
+    if (delay.count() > 0) {
+        std::this_thread::sleep_for(delay);
+    }
+
+    if (injectError) {
+        ++mInjectedErrors;
+        setJsonContent(res, mConfig.errorStatus, {{"error", "Injected error"}});
+    }
+    return injectError;
+}
+
+const Jukebox::Session &Jukebox::getSession(const std::string &sessionId) const {
+    const auto sessionIt {mSessions.find(sessionId)};
+    if (sessionIt == mSessions.cend()) {
+        throw RequestError {static_cast<int>(sk::HttpStatus::UNAUTHORIZED), "Unknown session"};
+    }
+    return sessionIt->second;
+}
+
+const Jukebox::Session &Jukebox::getAdminSession(const std::string &sessionId) const {
+    const auto &session {getSession(sessionId)};
+    if (!session.isAdmin) {
+        throw RequestError {static_cast<int>(sk::HttpStatus::UNAUTHORIZED), "Admin session required"};
+    }
+    return session;
+}
+
+const BaseTrack &Jukebox::getLibraryTrack(const std::string &trackId) const {
+    const auto indexIt {mLibraryIndex.find(trackId)};
+    if (indexIt == mLibraryIndex.cend()) {
+        throw RequestError {404, "Unknown track"};
+    }
+    return mLibrary[indexIt->second];
+}
+
+void Jukebox::updatePlayback() {
+    const auto now {std::chrono::steady_clock::now()};
+    if (mPlaying) {
+        mPlayedFor += std::chrono::duration_cast<std::chrono::milliseconds>(now - mLastUpdate);
+    }
+    mLastUpdate = now;
+
+    // Advance through the queues as tracks finish
+    while (mCurrentlyPlaying && mPlayedFor.count() >= mCurrentlyPlaying->duration) {
+        const auto overlap {mPlayedFor - std::chrono::milliseconds(mCurrentlyPlaying->duration)};
+        playNextTrack();
+        mPlayedFor = overlap;
+    }
+}
+
+void Jukebox::playNextTrack() {
+    mPlayedFor = std::chrono::milliseconds(0);
+
+    // The admin queue takes precedence over the normal queue
+    if (!mAdminQueue.empty()) {
+        mCurrentlyPlaying = std::move(mAdminQueue.front());
+        mAdminQueue.erase(std::begin(mAdminQueue));
+    } else if (!mNormalQueue.empty()) {
+        mCurrentlyPlaying = std::move(mNormalQueue.front().track);
+        mNormalQueue.erase(std::begin(mNormalQueue));
+    } else {
+        mCurrentlyPlaying = std::nullopt;
+    }
+}
+
+// Counting the votes of a track takes as long as it has votes, so it is done once per track, not per comparison
+void Jukebox::sortNormalQueue() {
+    std::vector<std::pair<int, size_t>> order;
+    order.reserve(std::size(mNormalQueue));
+    for (size_t i {0}; i < std::size(mNormalQueue); ++i) {
+        order.emplace_back(countVotes(mNormalQueue[i].baseVotes, mNormalQueue[i].votes), i);
+    }
+    std::stable_sort(std::begin(order), std::end(order),
+                     [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    std::vector<NormalQueueEntry> sorted;
+    sorted.reserve(std::size(mNormalQueue));
+    for (const auto &[votes, index] : order) {
+        sorted.push_back(std::move(mNormalQueue[index]));
+    }
+    mNormalQueue = std::move(sorted);
+}
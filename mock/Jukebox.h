@@ -0,0 +1,154 @@
+/*****************************************************************************/
+/**
+ * @file    Jukebox.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of an in-memory VirtualJukebox, serving the REST API version 1 for local measurements
+ */
+/*****************************************************************************/
+
+#ifndef MOCK_JUKEBOX_H
+#define MOCK_JUKEBOX_H
+
+#include "api/v1/ApiTypes.h"
+
+#include <httplib/httplib.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace mock {
+
+    struct JukeboxConfig {
+        // Amount of tracks which can be found by queryTracks
+        size_t librarySize {1000};
+
+        // Initial length of the queues; a track is playing as well
+        size_t normalQueueSize {25};
+        size_t adminQueueSize {5};
+
+        std::string adminPassword {"admin"};
+
+        // Every request is delayed by latency plus a uniformly distributed value in [0, latencyJitter]
+        std::chrono::milliseconds latency {0};
+        std::chrono::milliseconds latencyJitter {0};
+
+        // Fraction of requests, which are answered with errorStatus instead of being processed
+        double errorRate {0.0};
+        int errorStatus {503};
+
+        // Answers getCurrentQueues with an ETag and honors If-None-Match
+        bool etags {true};
+
+        //
+        // Repeats the Content-Length of the full queues in a 304 answer, which RFC 7232 allows. httplib::Server
+        // appends a "Content-Length: 0" behind it, but clients read the first one and must not wait for a body.
+        //
+        bool notModifiedLength {false};
+
+        // Seeds the generated library, the initial votes, the jitter and the injected errors
+        unsigned int seed {42};
+    };
+
+    struct JukeboxStats {
+        size_t requests {0};
+        size_t injectedErrors {0};
+        size_t notModified {0};
+    };
+
+
+    class Jukebox {
+    public:
+        explicit Jukebox(const JukeboxConfig &config);
+
+        Jukebox(const Jukebox &) = delete;
+        Jukebox &operator=(const Jukebox &) = delete;
+
+        //
+        // Answers a request to any endpoint of the REST API version 1.
+        // Can be registered as handler of a httplib::Server or be called directly.
+        //
+        void handle(const httplib::Request &req, httplib::Response &res);
+
+        JukeboxStats getStats() const noexcept;
+
+    private:
+        struct Session {
+            std::string nickname;
+            bool isAdmin;
+        };
+
+        struct NormalQueueEntry {
+            api::v1::QueueTrack track;
+            int baseVotes;
+
+            // Current vote per session id
+            std::unordered_map<std::string, int> votes;
+        };
+
+        using Endpoint = void (Jukebox::*)(const httplib::Request &, httplib::Response &);
+
+
+        //
+        // Endpoint implementations, called with the state mutex held
+        //
+
+        void generateSession(const httplib::Request &, httplib::Response &);
+        void queryTracks(const httplib::Request &, httplib::Response &);
+        void getCurrentQueues(const httplib::Request &, httplib::Response &);
+        void addTrackToQueue(const httplib::Request &, httplib::Response &);
+        void voteTrack(const httplib::Request &, httplib::Response &);
+        void controlPlayer(const httplib::Request &, httplib::Response &);
+        void moveTrack(const httplib::Request &, httplib::Response &);
+        void removeTrack(const httplib::Request &, httplib::Response &);
+
+
+        //
+        // Helpers
+        //
+
+        bool injectFaults(httplib::Response &res);
+
+        const Session &getSession(const std::string &sessionId) const;
+        const Session &getAdminSession(const std::string &sessionId) const;
+        const api::v1::BaseTrack &getLibraryTrack(const std::string &trackId) const;
+
+        void updatePlayback();
+        void playNextTrack();
+        void sortNormalQueue();
+
+    private:
+        const JukeboxConfig mConfig;
+
+        std::mutex mRandomMutex;
+        std::mt19937 mRandom;
+
+        std::mutex mStateMutex;
+        std::vector<api::v1::BaseTrack> mLibrary;
+        std::unordered_map<std::string, size_t> mLibraryIndex;
+        std::unordered_map<std::string, Session> mSessions;
+        size_t mNextSessionId {0};
+
+        std::optional<api::v1::QueueTrack> mCurrentlyPlaying;
+        bool mPlaying {true};
+        std::chrono::milliseconds mPlayedFor {0};
+        std::chrono::steady_clock::time_point mLastUpdate;
+        int mVolume {50};
+
+        std::vector<NormalQueueEntry> mNormalQueue;
+        std::vector<api::v1::QueueTrack> mAdminQueue;
+
+        std::atomic<size_t> mRequests {0};
+        std::atomic<size_t> mInjectedErrors {0};
+        std::atomic<size_t> mNotModified {0};
+    };
+
+}  // namespace mock
+
+#endif
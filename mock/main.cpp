@@ -0,0 +1,88 @@
+#include "Jukebox.h"
+
+#include <docopt/docopt.h>
+#include <httplib/httplib.h>
+#include <spdlog/spdlog.h>
+
+#include <iostream>
+
+
+static constexpr auto USAGE {
+    R"(VirtualJukebox mock server.
+
+Serves the REST API version 1 from memory, so the client can be measured without a real backend.
+
+Usage:
+  virtualjukebox-mock-server [options]
+  virtualjukebox-mock-server (-h | --help)
+
+Options:
+  -h --help                Show this screen.
+  --host=<host>            Address to listen on [default: 127.0.0.1].
+  --port=<port>            Port to listen on [default: 8080].
+  --threads=<count>        Number of threads handling requests, each keep-alive connection
+                           occupies one while it is open [default: 64].
+  --library=<count>        Number of tracks found by queryTracks [default: 1000].
+  --normal-queue=<count>   Initial length of the normal queue [default: 25].
+  --admin-queue=<count>    Initial length of the admin queue [default: 5].
+  --password=<password>    Password for admin sessions [default: admin].
+  --latency=<ms>           Delay added to every response [default: 0].
+  --jitter=<ms>            Random additional delay of up to this many milliseconds [default: 0].
+  --error-rate=<rate>      Fraction of requests answered with an injected error [default: 0].
+  --error-status=<status>  HTTP status of injected errors [default: 503].
+  --seed=<seed>            Seed for the library, votes, jitter and injected errors [default: 42].
+  --no-etags               Answer getCurrentQueues without ETag, ignoring If-None-Match.
+  --304-length             Repeat the length of the full queues in the Content-Length of a 304 answer.
+  -v --verbose             Log every request.
+)"};
+
+
+int main(int argc, const char **argv) {
+    const auto args {docopt::docopt(USAGE, {std::next(argv), std::next(argv, argc)}, true)};
+
+    mock::JukeboxConfig config;
+    std::string host;
+    int port;
+    size_t threads;
+    try {
+        host                     = args.at("--host").asString();
+        port                     = std::stoi(args.at("--port").asString());
+        threads                  = std::stoul(args.at("--threads").asString());
+        config.librarySize       = std::stoul(args.at("--library").asString());
+        config.normalQueueSize   = std::stoul(args.at("--normal-queue").asString());
+        config.adminQueueSize    = std::stoul(args.at("--admin-queue").asString());
+        config.adminPassword     = args.at("--password").asString();
+        config.latency           = std::chrono::milliseconds(std::stol(args.at("--latency").asString()));
+        config.latencyJitter     = std::chrono::milliseconds(std::stol(args.at("--jitter").asString()));
+        config.errorRate         = std::stod(args.at("--error-rate").asString());
+        config.errorStatus       = std::stoi(args.at("--error-status").asString());
+        config.seed              = static_cast<unsigned int>(std::stoul(args.at("--seed").asString()));
+        config.etags             = !args.at("--no-etags").asBool();
+        config.notModifiedLength = args.at("--304-length").asBool();
+    } catch (const std::logic_error &) {
+        std::cerr << "Invalid option value" << std::endl << std::endl << USAGE;
+        return 1;
+    }
+
+    spdlog::set_level(args.at("--verbose").asBool() ? spdlog::level::debug : spdlog::level::info);
+
+    mock::Jukebox jukebox(config);
+
+    httplib::Server server;
+    server.set_tcp_nodelay(true);
+    server.new_task_queue = [threads] { return new httplib::ThreadPool(std::max<size_t>(threads, 1)); };
+
+    const auto handler {[&jukebox](const httplib::Request &req, httplib::Response &res) { jukebox.handle(req, res); }};
+    server.Get("/api/v1/.*", handler);
+    server.Post("/api/v1/.*", handler);
+    server.Put("/api/v1/.*", handler);
+    server.Delete("/api/v1/.*", handler);
+
+    spdlog::info("Listening on {}:{}", host, port);
+    if (!server.listen(host.c_str(), port)) {
+        spdlog::error("Failed to listen on {}:{}", host, port);
+        return 1;
+    }
+
+    return 0;
+}
@@ -7,8 +7,12 @@
 /*****************************************************************************/
 
 #include "Api.h"
+#include "HttpTransport.h"
 
 #include "deserializer.h"
+#include "endpoint.h"
+#include "sax_deserializer.h"
+#include "utils/Tracer.h"
 #include "utils/http-status.h"
 #include "utils/utils.h"
 
@@ -20,53 +24,38 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <map>
-#include <sstream>
+#include <utility>
 
 
 using json = nlohmann::json;
 using namespace api::v1;
 
 
-//
-// Helper functions
-//
-
-static std::string getRequestEndpoint(const std::string &endpoint) {
-    constexpr auto ENDPOINT_BASE_PATH {"/api/v1"};
-    return std::string(ENDPOINT_BASE_PATH) + "/" + endpoint;
-}
-
-static std::string getRequestEndpoint(const std::string &endpoint,
-                                      const std::map<std::string, std::string> &parameters) {
-    std::stringstream urlStream;
-    urlStream << getRequestEndpoint(endpoint);
-
-    bool firstParameter {true};
-
-    std::for_each(std::cbegin(parameters), std::cend(parameters), [&](const auto &kv) {
-        if (firstParameter) {
-            urlStream << "?";
-        } else {
-            urlStream << "&";
-        }
-        urlStream << kv.first << "=" << kv.second;
-        firstParameter = false;
-    });
-
-    return urlStream.str();
-}
-
-
 //
 // Singleton
 //
 
 std::unique_ptr<Api> Api::instance {nullptr};
+std::shared_ptr<CaptureWriter> Api::instanceCapture {nullptr};
+TransportFactory Api::instanceTransportFactory {nullptr};
 
 Api *Api::createInstance(const std::string &address, const unsigned int port) {
+    if (instanceTransportFactory) {
+        return createInstance(instanceTransportFactory);
+    }
+
     instance = std::make_unique<Api>(address, port);
+    instance->setCapture(instanceCapture);
+    return instance.get();
+}
+
+Api *Api::createInstance(TransportFactory transportFactory) {
+    instance = std::make_unique<Api>(std::move(transportFactory));
+    instance->setCapture(instanceCapture);
     return instance.get();
 }
 
@@ -77,26 +66,220 @@ Api *Api::getInstance() {
     return instance.get();
 }
 
+void Api::setInstanceCapture(std::shared_ptr<CaptureWriter> capture) { instanceCapture = std::move(capture); }
+
+void Api::setInstanceTransportFactory(TransportFactory transportFactory) {
+    instanceTransportFactory = std::move(transportFactory);
+}
+
 
 //
 // Constructors and Getters
 //
 
-Api::Api(const std::string &address, const unsigned int port) noexcept
-    : mAddress(address), mPort(port), mClient(address, int(port)) {}
+Api::Api(const std::string &address, const unsigned int port, const bool keepAlive)
+    : Api([address, port] { return std::make_unique<HttpTransport>(address, port); }, keepAlive) {}
 
-std::string Api::getSessionId() const {
-    if (!isSessionGenerated()) {
+Api::Api(TransportFactory transportFactory, const bool keepAlive)
+    : mTransportFactory(std::move(transportFactory)), mConnection(mTransportFactory(), keepAlive) {}
+
+std::string Api::getSessionId() const { return getSession()->id; }
+
+
+bool Api::isAdmin() const noexcept {
+    const auto session {std::atomic_load(&mSession)};
+    return session && session->isAdmin;
+}
+
+bool Api::isSessionGenerated() const noexcept { return std::atomic_load(&mSession) != nullptr; }
+
+std::shared_ptr<const Api::Session> Api::getSession() const {
+    auto session {std::atomic_load(&mSession)};
+    if (!session) {
         throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
     }
+    return session;
+}
+
+
+void Api::setParserMode(const ParserMode parserMode) noexcept { mParserMode = parserMode; }
+
+ParserMode Api::getParserMode() const noexcept { return mParserMode; }
+
+
+void Api::setWorkerCount(const size_t workerCount) {
+    std::lock_guard<std::mutex> lock(mWorkerPoolMutex);
+    mWorkerCount = std::max<size_t>(workerCount, 1);
+
+    // Recreate the pool with the new size on the next asynchronous call
+    mWorkerPool.reset();
+}
+
+size_t Api::getWorkerCount() const noexcept { return mWorkerCount; }
+
+
+void Api::setKeepAlive(const bool keepAlive) {
+    mConnection.setKeepAlive(keepAlive);
+
+    std::lock_guard<std::mutex> lock(mWorkerPoolMutex);
+    if (mWorkerPool) {
+        mWorkerPool->setKeepAlive(keepAlive);
+    }
+}
+
+bool Api::isKeepAlive() const noexcept { return mConnection.isKeepAlive(); }
+
+ConnectionStats Api::getConnectionStats() const noexcept {
+    auto stats {mConnection.getStats()};
+
+    std::lock_guard<std::mutex> lock(mWorkerPoolMutex);
+    if (mWorkerPool) {
+        const auto poolStats {mWorkerPool->getConnectionStats()};
+        stats.connectionsOpened += poolStats.connectionsOpened;
+        stats.requestsServed += poolStats.requestsServed;
+        stats.reconnects += poolStats.reconnects;
+    }
+    return stats;
+}
+
+void Api::resetConnectionStats() noexcept {
+    mConnection.resetStats();
 
-    return mSessionId;
+    std::lock_guard<std::mutex> lock(mWorkerPoolMutex);
+    if (mWorkerPool) {
+        mWorkerPool->resetConnectionStats();
+    }
 }
 
 
-bool Api::isAdmin() const noexcept { return mIsAdmin; }
+SingleFlightStats Api::getCoalescingStats() const noexcept {
+    const auto queuesStats {mQueuesFlight.getStats()};
+    const auto tracksStats {mTracksFlight.getStats()};
 
-bool Api::isSessionGenerated() const noexcept { return mIsSessionGenerated; }
+    SingleFlightStats stats;
+    stats.executed  = queuesStats.executed + tracksStats.executed;
+    stats.coalesced = queuesStats.coalesced + tracksStats.coalesced;
+    return stats;
+}
+
+void Api::resetCoalescingStats() noexcept {
+    mQueuesFlight.resetStats();
+    mTracksFlight.resetStats();
+}
+
+QueuesFetchStats Api::getQueuesFetchStats() const noexcept {
+    QueuesFetchStats stats;
+    stats.fetched     = mQueuesFetched;
+    stats.notModified = mQueuesNotModified;
+    stats.unchanged   = mQueuesUnchanged;
+    return stats;
+}
+
+void Api::resetQueuesFetchStats() noexcept {
+    mQueuesFetched     = 0;
+    mQueuesNotModified = 0;
+    mQueuesUnchanged   = 0;
+}
+
+void Api::startQueuePoller(const QueuePollerConfig &config) {
+    // The poller uses its own connection, so that it never waits for commands or asynchronous calls
+    auto connection {std::make_shared<Connection>(mTransportFactory(), mConnection.isKeepAlive())};
+    auto poller {std::make_unique<QueuePoller>([this, connection] { return getCurrentQueues(*connection); }, config)};
+
+    {
+        std::lock_guard<std::mutex> lock(mQueuePollerMutex);
+        std::swap(poller, mQueuePoller);
+    }
+    // A replaced poller is joined without holding the lock, just like in stopQueuePoller
+}
+
+void Api::stopQueuePoller() {
+    std::unique_ptr<QueuePoller> poller;
+    {
+        std::lock_guard<std::mutex> lock(mQueuePollerMutex);
+        poller = std::move(mQueuePoller);
+    }
+    // Joined without holding the lock, so that readers are not blocked by a poll in progress
+}
+
+bool Api::isQueuePollerRunning() const {
+    std::lock_guard<std::mutex> lock(mQueuePollerMutex);
+    return mQueuePoller != nullptr;
+}
+
+std::optional<QueuePollerStats> Api::getQueuePollerStats() const {
+    std::lock_guard<std::mutex> lock(mQueuePollerMutex);
+    if (!mQueuePoller) {
+        return std::nullopt;
+    }
+    return mQueuePoller->getStats();
+}
+
+std::shared_ptr<const QueuesSnapshot> Api::getQueuesSnapshot() const { return mQueuesStore.load(); }
+
+std::shared_ptr<const QueuesSnapshot> Api::getRecentQueues() {
+    const auto changedAt {mQueuesChangedAt.load()};
+
+    // Without the poller, the last snapshot may be arbitrarily old
+    if (isQueuePollerRunning()) {
+        auto snapshot {mQueuesStore.load()};
+        if (snapshot && snapshot->fetchedAt >= changedAt) {
+            return snapshot;
+        }
+    }
+
+    // A request already in flight may have been sent before the change, the next one is sent after it
+    auto snapshot {getCurrentQueues(mConnection)};
+    if (snapshot->fetchedAt < changedAt) {
+        snapshot = getCurrentQueues(mConnection);
+    }
+    return snapshot;
+}
+
+void Api::queuesChanged() {
+    mQueuesChangedAt = QueuesSnapshot::Clock::now();
+
+    // The next poll should not wait for the interval to pass
+    std::lock_guard<std::mutex> lock(mQueuePollerMutex);
+    if (mQueuePoller) {
+        mQueuePoller->refresh();
+    }
+}
+
+std::shared_ptr<const Api::QueuesValidator> Api::getQueuesValidator() const {
+    return std::atomic_load(&mQueuesValidator);
+}
+
+void Api::setQueuesValidator(std::shared_ptr<const QueuesValidator> validator) {
+    std::atomic_store(&mQueuesValidator, std::move(validator));
+}
+
+
+std::map<std::string, EndpointStats> Api::getRequestStats() const { return mRequestStats.getStats(); }
+
+void Api::resetRequestStats() { mRequestStats.reset(); }
+
+void Api::setSearchCacheConfig(const SearchCacheConfig &config) { mSearchCache.setConfig(config); }
+
+SearchCacheStats Api::getSearchCacheStats() const { return mSearchCache.getStats(); }
+
+void Api::resetSearchCacheStats() { mSearchCache.resetStats(); }
+
+void Api::clearSearchCache() { mSearchCache.clear(); }
+
+
+void Api::setCapture(std::shared_ptr<CaptureWriter> capture) { std::atomic_store(&mCapture, std::move(capture)); }
+
+std::shared_ptr<CaptureWriter> Api::getCapture() const { return std::atomic_load(&mCapture); }
+
+
+std::shared_ptr<WorkerPool> Api::getWorkerPool() {
+    std::lock_guard<std::mutex> lock(mWorkerPoolMutex);
+    if (!mWorkerPool) {
+        mWorkerPool = std::make_shared<WorkerPool>(mTransportFactory, mWorkerCount, mConnection.isKeepAlive());
+    }
+    return mWorkerPool;
+}
 
 
 //
@@ -119,57 +302,125 @@ static void verifyResponse(const std::shared_ptr<httplib::Response> &resp) {
     }
 }
 
-static json extractJsonBody(const std::shared_ptr<httplib::Response> &resp) {
+static httplib::Request makeRequest(const char *const method, const char *const url) {
+    httplib::Request req;
+    req.method = method;
+    req.path   = url;
+    return req;
+}
+
+static httplib::Request makeRequest(const char *const method, const char *const url, const json &requestBody) {
+    auto req {makeRequest(method, url)};
+    req.headers.emplace("Content-Type", "application/json");
+    req.body = requestBody.dump();
+    return req;
+}
+
+static json extractJsonBody(const std::string &body) {
     try {
-        return json::parse(resp->body);
+        return json::parse(body);
     } catch (...) {
-        throw InvalidFormatException("Response body is no valid JSON", resp->body);
+        throw InvalidFormatException("Response body is no valid JSON", body);
     }
 }
 
+template<typename F>
+static auto measureParse(RequestStats &stats, const std::string &url, F &&parse) {
+    const auto endpoint {getEndpointName(url)};
+    sk::TraceSpan span("parse", endpoint);
+
+    const auto start {std::chrono::steady_clock::now()};
+    // No braces: a nlohmann::json result would be wrapped into an array
+    auto result = parse();
+    stats.recordParse(endpoint, std::chrono::duration_cast<std::chrono::microseconds>(
+                                    std::chrono::steady_clock::now() - start));
+    return result;
+}
+
+// Queues which have been playing for the given time since they have been received
+static std::shared_ptr<const Queues> advancePlayback(std::shared_ptr<const Queues> queues,
+                                                     const std::chrono::milliseconds elapsed) {
+    if (!queues->currentlyPlaying || !queues->currentlyPlaying->playing || elapsed <= std::chrono::milliseconds(0)) {
+        return queues;
+    }
+
+    auto advanced {std::make_shared<Queues>(*queues)};
+    auto &playing {advanced->currentlyPlaying.value()};
+    playing.playingFor = int(std::min(std::chrono::milliseconds(playing.playingFor) + elapsed,
+                                      std::chrono::milliseconds(playing.duration))
+                                 .count());
+    return advanced;
+}
+
+
+std::shared_ptr<httplib::Response> Api::sendRequest(Connection &connection, const httplib::Request &request) {
+    const auto endpoint {getEndpointName(request.path)};
+    sk::TraceSpan span("http", endpoint, request.path);
+
+    RequestTiming timing;
+    const auto resp {connection.send(request, &timing)};
+    const bool succeeded {resp
+                          && (resp->status == static_cast<int>(sk::HttpStatus::OK)
+                              || resp->status == static_cast<int>(sk::HttpStatus::NOT_MODIFIED))};
+    mRequestStats.recordExchange(endpoint, timing, succeeded);
 
-json Api::doGetRequest(const char *const url) {
+    if (const auto capture {getCapture()}) {
+        capture->append(request, resp.get(), timing);
+    }
+    return resp;
+}
+
+
+json Api::doGetRequest(Connection &connection, const char *const url) {
     spdlog::debug("Api::doGetRequest: {}", url);
 
-    const auto resp {mClient.Get(url)};
+    const auto resp {sendRequest(connection, makeRequest("GET", url))};
     verifyResponse(resp);
-    return extractJsonBody(resp);
+    return measureParse(mRequestStats, url, [&] { return extractJsonBody(resp->body); });
 }
 
-json Api::doPostRequest(const char *const url, const json &requestBody) {
+json Api::doPostRequest(Connection &connection, const char *const url, const json &requestBody) {
     spdlog::debug("Api::doPostRequest: {}, {}", url, requestBody.dump());
-    const auto resp {mClient.Post(url, requestBody.dump(), "application/json")};
+    const auto resp {sendRequest(connection, makeRequest("POST", url, requestBody))};
 
     verifyResponse(resp);
-    return extractJsonBody(resp);
+    return measureParse(mRequestStats, url, [&] { return extractJsonBody(resp->body); });
 }
 
-json Api::doPutRequest(const char *const url, const json &requestBody) {
+json Api::doPutRequest(Connection &connection, const char *const url, const json &requestBody) {
     spdlog::debug("Api::doPutRequest: {}, {}", url, requestBody.dump());
-    const auto resp {mClient.Put(url, requestBody.dump(), "application/json")};
+    const auto resp {sendRequest(connection, makeRequest("PUT", url, requestBody))};
 
     verifyResponse(resp);
-    return extractJsonBody(resp);
+    return measureParse(mRequestStats, url, [&] { return extractJsonBody(resp->body); });
 }
 
-json Api::doDeleteRequest(const char *const url, const json &requestBody) {
+json Api::doDeleteRequest(Connection &connection, const char *const url, const json &requestBody) {
     spdlog::debug("Api::doDeleteRequest: {}, {}", url, requestBody.dump());
-    const auto resp {mClient.Delete(url, requestBody.dump(), "application/json")};
+    const auto resp {sendRequest(connection, makeRequest("DELETE", url, requestBody))};
 
     verifyResponse(resp);
-    return extractJsonBody(resp);
+    return measureParse(mRequestStats, url, [&] { return extractJsonBody(resp->body); });
 }
 
 
-json Api::doGetRequest(const std::string &url) { return doGetRequest(url.c_str()); }
-json Api::doPostRequest(const std::string &url, const json &requestBody) {
-    return doPostRequest(url.c_str(), requestBody);
+json Api::doGetRequest(Connection &connection, const std::string &url) { return doGetRequest(connection, url.c_str()); }
+
+std::string Api::doGetRequestBody(Connection &connection, const std::string &url) {
+    spdlog::debug("Api::doGetRequestBody: {}", url);
+
+    const auto resp {sendRequest(connection, makeRequest("GET", url.c_str()))};
+    verifyResponse(resp);
+    return std::move(resp->body);
+}
+json Api::doPostRequest(Connection &connection, const std::string &url, const json &requestBody) {
+    return doPostRequest(connection, url.c_str(), requestBody);
 }
-json Api::doPutRequest(const std::string &url, const json &requestBody) {
-    return doPutRequest(url.c_str(), requestBody);
+json Api::doPutRequest(Connection &connection, const std::string &url, const json &requestBody) {
+    return doPutRequest(connection, url.c_str(), requestBody);
 }
-json Api::doDeleteRequest(const std::string &url, const json &requestBody) {
-    return doDeleteRequest(url.c_str(), requestBody);
+json Api::doDeleteRequest(Connection &connection, const std::string &url, const json &requestBody) {
+    return doDeleteRequest(connection, url.c_str(), requestBody);
 }
 
 
@@ -187,18 +438,18 @@ void Api::generateSession(const std::optional<std::string> &nickname) {
         requestBody["nickname"] = nickname.value();
     }
 
-    const auto body = doPostRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doPostRequest(mConnection, getRequestEndpoint(ENDPOINT), requestBody);
 
+    auto session {std::make_shared<Session>()};
     try {
-        mSessionId = body.at("session_id");
+        session->id = body.at("session_id").get<std::string>();
     } catch (const json::out_of_range &) {
         throw InvalidFormatException("Response misses field 'session_id'", body.dump());
     } catch (const json::type_error &) {
         throw InvalidFormatException("Received JSON object is of wrong type", body.dump());
     }
 
-    mIsAdmin            = false;
-    mIsSessionGenerated = true;
+    std::atomic_store(&mSession, std::shared_ptr<const Session>(std::move(session)));
 }
 
 void Api::generateAdminSession(const std::string &adminPassword, const std::optional<std::string> &nickname) {
@@ -213,11 +464,12 @@ void Api::generateAdminSession(const std::string &adminPassword, const std::opti
         requestBody["nickname"] = nickname.value();
     }
 
-    const auto body = doPostRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doPostRequest(mConnection, getRequestEndpoint(ENDPOINT), requestBody);
 
 
+    auto session {std::make_shared<Session>()};
     try {
-        mSessionId = body.at("session_id");
+        session->id = body.at("session_id").get<std::string>();
     } catch (const json::out_of_range &) {
         throw InvalidFormatException("Response misses field 'session_id'", body.dump());
     } catch (const json::type_error &) {
@@ -225,152 +477,275 @@ void Api::generateAdminSession(const std::string &adminPassword, const std::opti
     }
 
 
-    mIsAdmin            = true;
-    mIsSessionGenerated = true;
+    session->isAdmin = true;
+    std::atomic_store(&mSession, std::shared_ptr<const Session>(std::move(session)));
 }
 
 
-std::vector<BaseTrack> Api::queryTracks(const std::string &pattern, const unsigned int maxEntries) {
+std::vector<BaseTrack> Api::queryTracks(Connection &connection, const std::string &pattern,
+                                        const unsigned int maxEntries) {
     spdlog::debug("Api::queryTracks: {}, {}", pattern, maxEntries);
 
     if (!isSessionGenerated()) {
         throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
     }
 
+    if (const auto cachedTracks {mSearchCache.find(pattern, maxEntries)}) {
+        return *cachedTracks;
+    }
+
     constexpr auto ENDPOINT {"queryTracks"};
 
     const std::map<std::string, std::string> parameters {
         {"pattern", pattern},                        //
         {"max_entries", std::to_string(maxEntries)}  //
     };
-    const auto body = doGetRequest(getRequestEndpoint(ENDPOINT, parameters));
+    const auto url {getRequestEndpoint(ENDPOINT, parameters)};
 
+    return mTracksFlight.run(url, [&] {
+        const auto responseBody {doGetRequestBody(connection, url)};
 
-    try {
-        return deserialize<std::vector<BaseTrack>>(body.at("tracks"));
-    } catch (const json::out_of_range &) {
-        throw InvalidFormatException("An expected field could not be found in JSON object.", body.dump());
-    } catch (const json::type_error &) {
-        throw InvalidFormatException("Received JSON object is of wrong type", body.dump());
-    }
+        auto tracks {measureParse(mRequestStats, url, [&] {
+            if (mParserMode == ParserMode::SAX) {
+                return sax::deserialize<std::vector<BaseTrack>>(responseBody);
+            }
+
+            const auto body = extractJsonBody(responseBody);
+
+            try {
+                return deserialize<std::vector<BaseTrack>>(body.at("tracks"));
+            } catch (const json::out_of_range &) {
+                throw InvalidFormatException("An expected field could not be found in JSON object.", body.dump());
+            } catch (const json::type_error &) {
+                throw InvalidFormatException("Received JSON object is of wrong type", body.dump());
+            }
+        })};
+
+        mSearchCache.insert(pattern, maxEntries, tracks);
+        return tracks;
+    });
 }
 
 
-Queues Api::getCurrentQueues() {
+std::shared_ptr<const QueuesSnapshot> Api::getCurrentQueues(Connection &connection) {
     spdlog::debug("Api::getCurrentQueues");
 
-    if (!isSessionGenerated()) {
-        throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
-    }
+    const auto session {getSession()};
 
     constexpr auto ENDPOINT {"getCurrentQueues"};
 
     const std::map<std::string, std::string> parameters {
-        {"session_id", mSessionId}  //
+        {"session_id", session->id}  //
     };
-    const auto body = doGetRequest(getRequestEndpoint(ENDPOINT, parameters));
+    const auto url {getRequestEndpoint(ENDPOINT, parameters)};
+
+    // Concurrent callers share the response of the request already in flight
+    return mQueuesFlight.run(url, [&] {
+        // Queues of other sessions differ in the votes placed, so a validator is only valid for its own URL
+        auto validator {getQueuesValidator()};
+        if (validator && validator->url != url) {
+            validator = nullptr;
+        }
 
+        auto request {makeRequest("GET", url.c_str())};
+        if (validator && !validator->etag.empty()) {
+            request.headers.emplace("If-None-Match", validator->etag);
+        }
 
-    try {
-        return deserialize<Queues>(body);
-    } catch (const json::out_of_range &) {
-        throw InvalidFormatException("An expected field could not be found in JSON object.", body.dump());
-    }
+        // The response shows at least every change completed before the request has been sent
+        const auto fetchedAt {QueuesSnapshot::Clock::now()};
+        const auto resp {sendRequest(connection, request)};
+        ++mQueuesFetched;
+
+        // ETags do not cover the progress of the playing track, which changes all the time
+        if (validator && resp && resp->status == static_cast<int>(sk::HttpStatus::NOT_MODIFIED)) {
+            ++mQueuesNotModified;
+            const auto elapsed {
+                std::chrono::duration_cast<std::chrono::milliseconds>(fetchedAt - validator->fetchedAt)};
+            return mQueuesStore.publish(advancePlayback(validator->queues, elapsed), fetchedAt, validator->queues);
+        }
+        verifyResponse(resp);
+
+        // Servers without ETags still send the very same body as long as nothing changed
+        if (validator && validator->body == resp->body) {
+            ++mQueuesUnchanged;
+            return mQueuesStore.publish(validator->queues, fetchedAt);
+        }
+
+        auto newValidator {std::make_shared<QueuesValidator>()};
+        newValidator->url       = url;
+        newValidator->etag      = resp->get_header_value("ETag");
+        newValidator->body      = resp->body;
+        newValidator->fetchedAt = fetchedAt;
+        newValidator->queues    = std::make_shared<const Queues>(measureParse(mRequestStats, url, [&] {
+            if (mParserMode == ParserMode::SAX) {
+                return sax::deserialize<Queues>(resp->body);
+            }
+
+            const auto body = extractJsonBody(resp->body);
+
+            try {
+                return deserialize<Queues>(body);
+            } catch (const json::out_of_range &) {
+                throw InvalidFormatException("An expected field could not be found in JSON object.", body.dump());
+            }
+        }));
+
+        setQueuesValidator(newValidator);
+        return mQueuesStore.publish(newValidator->queues, fetchedAt);
+    });
 }
 
-void Api::addTrack(const BaseTrack &track, const QueueType queueType) {
+void Api::addTrack(Connection &connection, const BaseTrack &track, const QueueType queueType) {
     spdlog::debug("Api::addTrack: {}, {}", track.trackId, to_string(queueType));
 
-    if (!isSessionGenerated()) {
-        throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
-    }
-    if (queueType == QueueType::ADMIN && !isAdmin()) {
+    const auto session {getSession()};
+    if (queueType == QueueType::ADMIN && !session->isAdmin) {
         throw APIException(APIExceptionCode::ADMIN_REQUIRED);
     }
 
     constexpr auto ENDPOINT {"addTrackToQueue"};
 
     const json requestBody {
-        {"session_id", mSessionId},           //
+        {"session_id", session->id},          //
         {"track_id", track.trackId},          //
         {"queue_type", to_string(queueType)}  //
     };
 
-    const auto body = doPostRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doPostRequest(connection, getRequestEndpoint(ENDPOINT), requestBody);
+
+    queuesChanged();
 }
 
-void Api::voteTrack(const BaseTrack &track, const Vote vote) {
+void Api::voteTrack(Connection &connection, const BaseTrack &track, const Vote vote) {
     spdlog::debug("Api::voteTrack: {}, {}", track.trackId, vote);
 
-    if (!isSessionGenerated()) {
-        throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
-    }
+    const auto session {getSession()};
 
     constexpr auto ENDPOINT {"voteTrack"};
 
     const json requestBody {
-        {"session_id", mSessionId},       //
+        {"session_id", session->id},      //
         {"track_id", track.trackId},      //
         {"vote", static_cast<int>(vote)}  //
     };
-    const auto body = doPutRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doPutRequest(connection, getRequestEndpoint(ENDPOINT), requestBody);
+
+    queuesChanged();
 }
 
 
-void Api::controlPlayer(const PlayerAction action) {
+void Api::controlPlayer(Connection &connection, const PlayerAction action) {
     spdlog::debug("Api::controlPlayer: {}", to_string(action));
 
-    if (!isSessionGenerated()) {
-        throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
-    }
-    if (!isAdmin()) {
+    const auto session {getSession()};
+    if (!session->isAdmin) {
         throw APIException(APIExceptionCode::ADMIN_REQUIRED);
     }
 
     constexpr auto ENDPOINT {"controlPlayer"};
 
     const json requestBody {
-        {"session_id", mSessionId},           //
+        {"session_id", session->id},          //
         {"player_action", to_string(action)}  //
     };
-    const auto body = doPutRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doPutRequest(connection, getRequestEndpoint(ENDPOINT), requestBody);
+
+    queuesChanged();
 }
 
-void Api::moveTrack(const BaseTrack &track, const QueueType queueType) {
+void Api::moveTrack(Connection &connection, const BaseTrack &track, const QueueType queueType) {
     spdlog::debug("Api::moveTrack: {}, {}", track.trackId, to_string(queueType));
 
-    if (!isSessionGenerated()) {
-        throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
-    }
-    if (!isAdmin()) {
+    const auto session {getSession()};
+    if (!session->isAdmin) {
         throw APIException(APIExceptionCode::ADMIN_REQUIRED);
     }
 
     constexpr auto ENDPOINT {"moveTrack"};
 
     const json requestBody {
-        {"session_id", mSessionId},           //
+        {"session_id", session->id},          //
         {"track_id", track.trackId},          //
         {"queue_type", to_string(queueType)}  //
     };
-    const auto body = doPutRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doPutRequest(connection, getRequestEndpoint(ENDPOINT), requestBody);
+
+    queuesChanged();
 }
 
-void Api::removeTrack(const BaseTrack &track) {
+void Api::removeTrack(Connection &connection, const BaseTrack &track) {
     spdlog::debug("Api::removeTrack: {}", track.trackId);
 
-    if (!isSessionGenerated()) {
-        throw APIException(APIExceptionCode::NO_SESSION_GENERATED);
-    }
-    if (!isAdmin()) {
+    const auto session {getSession()};
+    if (!session->isAdmin) {
         throw APIException(APIExceptionCode::ADMIN_REQUIRED);
     }
 
     constexpr auto ENDPOINT {"removeTrack"};
 
     const json requestBody {
-        {"session_id", mSessionId},  //
-        {"track_id", track.trackId}  //
+        {"session_id", session->id},  //
+        {"track_id", track.trackId}   //
     };
-    const auto body = doDeleteRequest(getRequestEndpoint(ENDPOINT), requestBody);
+    const auto body = doDeleteRequest(connection, getRequestEndpoint(ENDPOINT), requestBody);
+
+    queuesChanged();
+}
+
+
+//
+// Blocking endpoints, running on the connection owned by the Api itself
+//
+
+std::vector<BaseTrack> Api::queryTracks(const std::string &pattern, const unsigned int maxEntries) {
+    return queryTracks(mConnection, pattern, maxEntries);
+}
+
+Queues Api::getCurrentQueues() { return *getCurrentQueues(mConnection)->queues; }
+
+void Api::addTrack(const BaseTrack &track, const QueueType queueType) { addTrack(mConnection, track, queueType); }
+
+void Api::voteTrack(const BaseTrack &track, const Vote vote) { voteTrack(mConnection, track, vote); }
+
+void Api::controlPlayer(const PlayerAction action) { controlPlayer(mConnection, action); }
+
+void Api::moveTrack(const BaseTrack &track, const QueueType queueType) { moveTrack(mConnection, track, queueType); }
+
+void Api::removeTrack(const BaseTrack &track) { removeTrack(mConnection, track); }
+
+
+//
+// Asynchronous endpoints, running on the connections of the worker pool
+//
+
+std::future<std::vector<BaseTrack>> Api::queryTracksAsync(const std::string &pattern, const unsigned int maxEntries) {
+    return getWorkerPool()->submit(
+        [this, pattern, maxEntries](Connection &connection) { return queryTracks(connection, pattern, maxEntries); });
+}
+
+std::future<Queues> Api::getCurrentQueuesAsync() {
+    return getWorkerPool()->submit([this](Connection &connection) { return *getCurrentQueues(connection)->queues; });
+}
+
+std::future<void> Api::addTrackAsync(const BaseTrack &track, const QueueType queueType) {
+    return getWorkerPool()->submit(
+        [this, track, queueType](Connection &connection) { addTrack(connection, track, queueType); });
+}
+
+std::future<void> Api::voteTrackAsync(const BaseTrack &track, const Vote vote) {
+    return getWorkerPool()->submit([this, track, vote](Connection &connection) { voteTrack(connection, track, vote); });
+}
+
+std::future<void> Api::controlPlayerAsync(const PlayerAction action) {
+    return getWorkerPool()->submit([this, action](Connection &connection) { controlPlayer(connection, action); });
+}
+
+std::future<void> Api::moveTrackAsync(const BaseTrack &track, const QueueType queueType) {
+    return getWorkerPool()->submit(
+        [this, track, queueType](Connection &connection) { moveTrack(connection, track, queueType); });
+}
+
+std::future<void> Api::removeTrackAsync(const BaseTrack &track) {
+    return getWorkerPool()->submit([this, track](Connection &connection) { removeTrack(connection, track); });
 }
@@ -10,53 +10,204 @@
 #define API_V1_H
 
 #include "api/v1/ApiTypes.h"
+#include "api/v1/Capture.h"
+#include "api/v1/Connection.h"
+#include "api/v1/QueuePoller.h"
+#include "api/v1/RequestStats.h"
+#include "api/v1/SearchCache.h"
+#include "api/v1/SingleFlight.h"
+#include "api/v1/Transport.h"
+#include "api/v1/WorkerPool.h"
+#include "api/v1/sax_deserializer.h"
 
 #include <httplib/httplib.h>
 #include <nlohmann/json.hpp>
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+
 
 namespace api::v1 {
 
+    struct QueuesFetchStats {
+        size_t fetched {0};
+
+        // Responses answered from the last snapshot, either by the server (304) or by comparing the body
+        size_t notModified {0};
+        size_t unchanged {0};
+    };
+
+
     class Api {
     private:
         static std::unique_ptr<Api> instance;
 
+        // Applied to every instance created from then on, e.g. by the command line before the first login
+        static std::shared_ptr<CaptureWriter> instanceCapture;
+        static TransportFactory instanceTransportFactory;
+
     public:
+        // Connects to the address, unless a transport factory has been set for all instances
         static Api *createInstance(const std::string &address, const unsigned int port);
+        static Api *createInstance(TransportFactory transportFactory);
         static Api *getInstance();
 
+        static void setInstanceCapture(std::shared_ptr<CaptureWriter> capture);
+        static void setInstanceTransportFactory(TransportFactory transportFactory);
+
+
+    public:
+        static constexpr size_t DEFAULT_WORKER_COUNT {4};
 
     private:
-        std::string mAddress;
-        unsigned int mPort;
-        httplib::Client mClient;
+        // Every connection, including the ones of the workers and the poller, gets a transport of its own
+        TransportFactory mTransportFactory;
+        Connection mConnection;
+
+        struct Session {
+            std::string id;
+            bool isAdmin {false};
+        };
+
+        // Replaced as a whole by every login, while the workers may read it. Only accessed through the atomic
+        // shared_ptr functions.
+        std::shared_ptr<const Session> mSession;
+        std::atomic<ParserMode> mParserMode {ParserMode::SAX};
 
-        std::string mSessionId;
-        bool mIsAdmin;
-        bool mIsSessionGenerated = false;
+        RequestStats mRequestStats;
+
+        // Records every exchange while set, only accessed through the atomic shared_ptr functions
+        std::shared_ptr<CaptureWriter> mCapture;
+
+        // Search results are served from here before asking the server
+        SearchCache mSearchCache;
+
+        // Last queues received, so that unchanged responses do not need to be transferred or parsed again
+        struct QueuesValidator {
+            std::string url;
+            std::string etag;
+            std::string body;
+            QueuesSnapshot::Clock::time_point fetchedAt;
+            std::shared_ptr<const Queues> queues;
+        };
+
+        // Only accessed through the atomic shared_ptr functions
+        std::shared_ptr<const QueuesValidator> mQueuesValidator;
+
+        // Most recent queues of any request, readable without waiting for one
+        QueuesStore mQueuesStore;
+
+        // When this client last changed the queues, older snapshots do not show that change yet
+        std::atomic<QueuesSnapshot::Clock::time_point> mQueuesChangedAt {QueuesSnapshot::Clock::time_point()};
+
+        std::atomic<size_t> mQueuesFetched {0};
+        std::atomic<size_t> mQueuesNotModified {0};
+        std::atomic<size_t> mQueuesUnchanged {0};
+
+        // Coalesce concurrent GET requests with the same endpoint and parameters
+        SingleFlight<std::shared_ptr<const QueuesSnapshot>> mQueuesFlight;
+        SingleFlight<std::vector<BaseTrack>> mTracksFlight;
+
+        // Created on the first asynchronous call. Declared last, so that the workers are joined
+        // before any of the state they access gets destroyed. Callers submit to a shared copy, so
+        // replacing the pool never destroys one which is still in use.
+        size_t mWorkerCount {DEFAULT_WORKER_COUNT};
+        mutable std::mutex mWorkerPoolMutex;
+        std::shared_ptr<WorkerPool> mWorkerPool;
+
+        // Optional, keeps the queues up to date in the background. Declared after everything it uses.
+        mutable std::mutex mQueuePollerMutex;
+        std::unique_ptr<QueuePoller> mQueuePoller;
 
     private:
-        nlohmann::json doGetRequest(const char *const url);
-        nlohmann::json doGetRequest(const std::string &url);
+        std::shared_ptr<httplib::Response> sendRequest(Connection &, const httplib::Request &);
+
+        nlohmann::json doGetRequest(Connection &, const char *const url);
+        nlohmann::json doGetRequest(Connection &, const std::string &url);
+        std::string doGetRequestBody(Connection &, const std::string &url);
 
-        nlohmann::json doPostRequest(const char *const url, const nlohmann::json &requestBody);
-        nlohmann::json doPostRequest(const std::string &url, const nlohmann::json &requestBody);
+        nlohmann::json doPostRequest(Connection &, const char *const url, const nlohmann::json &requestBody);
+        nlohmann::json doPostRequest(Connection &, const std::string &url, const nlohmann::json &requestBody);
 
-        nlohmann::json doPutRequest(const char *const url, const nlohmann::json &requestBody);
-        nlohmann::json doPutRequest(const std::string &url, const nlohmann::json &requestBody);
+        nlohmann::json doPutRequest(Connection &, const char *const url, const nlohmann::json &requestBody);
+        nlohmann::json doPutRequest(Connection &, const std::string &url, const nlohmann::json &requestBody);
 
-        nlohmann::json doDeleteRequest(const char *const url, const nlohmann::json &requestBody);
-        nlohmann::json doDeleteRequest(const std::string &url, const nlohmann::json &requestBody);
+        nlohmann::json doDeleteRequest(Connection &, const char *const url, const nlohmann::json &requestBody);
+        nlohmann::json doDeleteRequest(Connection &, const std::string &url, const nlohmann::json &requestBody);
+
+        std::shared_ptr<WorkerPool> getWorkerPool();
+
+        // Throws if no session has been generated yet
+        std::shared_ptr<const Session> getSession() const;
+
+        // Called after every change of the queues made by this client
+        void queuesChanged();
+
+        std::shared_ptr<const QueuesValidator> getQueuesValidator() const;
+        void setQueuesValidator(std::shared_ptr<const QueuesValidator> validator);
+
+
+        //
+        // Endpoint implementations, which may run on any connection
+        //
+
+        std::vector<BaseTrack> queryTracks(Connection &, const std::string &pattern, const unsigned int maxEntries);
+        std::shared_ptr<const QueuesSnapshot> getCurrentQueues(Connection &);
+        void addTrack(Connection &, const BaseTrack &, const QueueType);
+        void voteTrack(Connection &, const BaseTrack &, const Vote vote);
+        void controlPlayer(Connection &, const PlayerAction action);
+        void moveTrack(Connection &, const BaseTrack &, const QueueType);
+        void removeTrack(Connection &, const BaseTrack &);
 
 
     public:
-        Api(const std::string &address, const unsigned int port) noexcept;
+        Api(const std::string &address, const unsigned int port, const bool keepAlive = true);
+        explicit Api(TransportFactory transportFactory, const bool keepAlive = true);
 
         std::string getSessionId() const;
 
         bool isAdmin() const noexcept;
         bool isSessionGenerated() const noexcept;
 
+        void setParserMode(const ParserMode parserMode) noexcept;
+        ParserMode getParserMode() const noexcept;
+
+        void setWorkerCount(const size_t workerCount);
+        size_t getWorkerCount() const noexcept;
+
+        void setKeepAlive(const bool keepAlive);
+        bool isKeepAlive() const noexcept;
+        ConnectionStats getConnectionStats() const noexcept;
+        void resetConnectionStats() noexcept;
+        SingleFlightStats getCoalescingStats() const noexcept;
+        void resetCoalescingStats() noexcept;
+        QueuesFetchStats getQueuesFetchStats() const noexcept;
+        void resetQueuesFetchStats() noexcept;
+        std::map<std::string, EndpointStats> getRequestStats() const;
+        void resetRequestStats();
+        void setSearchCacheConfig(const SearchCacheConfig &config);
+        SearchCacheStats getSearchCacheStats() const;
+        void resetSearchCacheStats();
+        void clearSearchCache();
+
+        // Records all further exchanges of every connection, until nullptr is set
+        void setCapture(std::shared_ptr<CaptureWriter> capture);
+        std::shared_ptr<CaptureWriter> getCapture() const;
+
+        void startQueuePoller(const QueuePollerConfig &config = {});
+        void stopQueuePoller();
+        bool isQueuePollerRunning() const;
+        std::optional<QueuePollerStats> getQueuePollerStats() const;
+
+        // Most recent queues received by any request or nullptr, if none have been fetched yet
+        std::shared_ptr<const QueuesSnapshot> getQueuesSnapshot() const;
+
+        // Queues of the poller, if available and not older than the last change made by this client, otherwise
+        // fetched right away
+        std::shared_ptr<const QueuesSnapshot> getRecentQueues();
+
 
         //
         // Api methods
@@ -71,6 +222,20 @@ namespace api::v1 {
         void controlPlayer(const PlayerAction action);
         void moveTrack(const BaseTrack &, const QueueType);
         void removeTrack(const BaseTrack &);
+
+
+        //
+        // Asynchronous variants of the Api methods, executed by the worker pool
+        //
+
+        std::future<std::vector<BaseTrack>> queryTracksAsync(const std::string &pattern,
+                                                             const unsigned int maxEntries = 10);
+        std::future<Queues> getCurrentQueuesAsync();
+        std::future<void> addTrackAsync(const BaseTrack &, const QueueType = QueueType::NORMAL);
+        std::future<void> voteTrackAsync(const BaseTrack &, const Vote vote);
+        std::future<void> controlPlayerAsync(const PlayerAction action);
+        std::future<void> moveTrackAsync(const BaseTrack &, const QueueType);
+        std::future<void> removeTrackAsync(const BaseTrack &);
     };
 
 }  // namespace api::v1
@@ -11,6 +11,7 @@
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "exceptions/APIException.h"
@@ -98,10 +99,10 @@ namespace api::v1 {
 
 
     template<typename T>
-    inline T from_string(const std::string &str);
+    inline T from_string(const std::string_view str);
 
     template<>
-    inline QueueType from_string(const std::string &str) {
+    inline QueueType from_string(const std::string_view str) {
         if (str == "normal") {
             return QueueType::NORMAL;
         } else if (str == "admin") {
@@ -112,7 +113,7 @@ namespace api::v1 {
     }
 
     template<>
-    inline PlayerAction from_string(const std::string &str) {
+    inline PlayerAction from_string(const std::string_view str) {
         if (str == "play") {
             return PlayerAction::PLAY;
         } else if (str == "pause") {
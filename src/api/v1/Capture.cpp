@@ -0,0 +1,273 @@
+/*****************************************************************************/
+/**
+ * @file    Capture.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of the append-only file recording the HTTP exchanges of an Api
+ */
+/*****************************************************************************/
+
+#include "Capture.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+using namespace api::v1;
+
+
+//
+// Record encoding, all integers are stored little-endian with a fixed width
+//
+
+namespace {
+
+    constexpr std::string_view CAPTURE_MAGIC {"VJCAPTURE 1\n"};
+
+    void putInteger(std::string &record, const uint64_t value, const size_t width) {
+        for (size_t i {0}; i < width; ++i) {
+            record.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void putString(std::string &record, const std::string &value) {
+        putInteger(record, std::size(value), 4);
+        record.append(value);
+    }
+
+    void putDuration(std::string &record, const std::chrono::microseconds duration) {
+        putInteger(record, uint64_t(duration.count()), 8);
+    }
+
+
+    class RecordReader {
+    public:
+        explicit RecordReader(std::string_view data) : mData(data) {}
+
+        // Whether every field read so far was complete
+        bool isValid() const noexcept { return mValid; }
+        bool isAtEnd() const noexcept { return mData.empty(); }
+
+        template <typename T>
+        T getInteger(const size_t width) {
+            if (std::size(mData) < width) {
+                mValid = false;
+                mData  = {};
+                return 0;
+            }
+
+            T value {0};
+            for (size_t i {0}; i < width; ++i) {
+                value |= T(static_cast<unsigned char>(mData[i])) << (8 * i);
+            }
+            mData.remove_prefix(width);
+            return value;
+        }
+
+        std::string_view getBytes(const size_t size) {
+            if (std::size(mData) < size) {
+                mValid = false;
+                mData  = {};
+                return {};
+            }
+
+            const auto bytes {mData.substr(0, size)};
+            mData.remove_prefix(size);
+            return bytes;
+        }
+
+        std::string getString() {
+            const auto size {getInteger<size_t>(4)};
+            return std::string(getBytes(size));
+        }
+
+        std::chrono::microseconds getDuration() {
+            return std::chrono::microseconds(static_cast<std::chrono::microseconds::rep>(getInteger<uint64_t>(8)));
+        }
+
+    private:
+        std::string_view mData;
+        bool mValid {true};
+    };
+
+
+    std::optional<CapturedExchange> decodeExchange(std::string_view record) {
+        RecordReader reader(record);
+
+        CapturedExchange exchange;
+        exchange.offset      = reader.getDuration();
+        exchange.method      = reader.getString();
+        exchange.path        = reader.getString();
+        exchange.requestBody = reader.getString();
+        exchange.responded   = reader.getInteger<unsigned int>(1) != 0;
+        exchange.status      = static_cast<int32_t>(reader.getInteger<uint32_t>(4));
+
+        const auto headerCount {reader.getInteger<size_t>(4)};
+        for (size_t i {0}; i < headerCount && reader.isValid(); ++i) {
+            auto name {reader.getString()};
+            auto value {reader.getString()};
+            exchange.responseHeaders.emplace(std::move(name), std::move(value));
+        }
+        exchange.responseBody = reader.getString();
+
+        exchange.timing.connect       = reader.getDuration();
+        exchange.timing.send          = reader.getDuration();
+        exchange.timing.wait          = reader.getDuration();
+        exchange.timing.receive       = reader.getDuration();
+        exchange.timing.bytesSent     = reader.getInteger<size_t>(8);
+        exchange.timing.bytesReceived = reader.getInteger<size_t>(8);
+
+        if (!reader.isValid() || !reader.isAtEnd()) {
+            return std::nullopt;
+        }
+        return exchange;
+    }
+
+}  // namespace
+
+
+//
+// Constructors
+//
+
+std::shared_ptr<CaptureWriter> CaptureWriter::open(const std::string &path) {
+#ifndef _WIN32
+    // Requests carry session ids and admin passwords, so only the user may read the capture. The file is created
+    // with these permissions right away, an existing one is restricted before anything is written to it.
+    const auto fd {::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR)};
+    if (fd < 0) {
+        return nullptr;
+    }
+    const bool restricted {::fchmod(fd, S_IRUSR | S_IWUSR) == 0};
+    ::close(fd);
+    if (!restricted) {
+        return nullptr;
+    }
+#endif
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return nullptr;
+    }
+
+    file.write(CAPTURE_MAGIC.data(), std::streamsize(std::size(CAPTURE_MAGIC)));
+    file.flush();
+    if (!file) {
+        return nullptr;
+    }
+
+    // The constructor is private, so std::make_shared cannot be used
+    return std::shared_ptr<CaptureWriter>(new CaptureWriter(std::move(file)));
+}
+
+CaptureWriter::CaptureWriter(std::ofstream file) : mFile(std::move(file)), mOrigin(std::chrono::steady_clock::now()) {}
+
+
+//
+// Recording
+//
+
+void CaptureWriter::append(const httplib::Request &request, const httplib::Response *response,
+                           const RequestTiming &timing) {
+    // The exchange started when the request has been sent, not when its response was complete
+    const auto elapsed {
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - mOrigin)};
+    const auto offset {elapsed - timing.connect - timing.send - timing.wait - timing.receive};
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // The size prefix is filled in once the record is complete
+    mRecord.assign(4, '\0');
+    putDuration(mRecord, std::max(offset, std::chrono::microseconds(0)));
+    putString(mRecord, request.method);
+    putString(mRecord, request.path);
+    putString(mRecord, request.body);
+    putInteger(mRecord, response ? 1 : 0, 1);
+    putInteger(mRecord, response ? uint32_t(response->status) : uint32_t(-1), 4);
+
+    putInteger(mRecord, response ? std::size(response->headers) : 0, 4);
+    if (response) {
+        for (const auto &[name, value] : response->headers) {
+            putString(mRecord, name);
+            putString(mRecord, value);
+        }
+    }
+    putString(mRecord, response ? response->body : std::string());
+
+    putDuration(mRecord, timing.connect);
+    putDuration(mRecord, timing.send);
+    putDuration(mRecord, timing.wait);
+    putDuration(mRecord, timing.receive);
+    putInteger(mRecord, timing.bytesSent, 8);
+    putInteger(mRecord, timing.bytesReceived, 8);
+
+    const auto recordSize {std::size(mRecord) - 4};
+    for (size_t i {0}; i < 4; ++i) {
+        mRecord[i] = char((recordSize >> (8 * i)) & 0xFF);
+    }
+
+    mFile.write(mRecord.data(), std::streamsize(std::size(mRecord)));
+    mFile.flush();
+    if (!mFile) {
+        spdlog::warn("CaptureWriter::append: failed to write exchange {} {}", request.method, request.path);
+        mFile.clear();
+        return;
+    }
+    ++mExchangeCount;
+}
+
+size_t CaptureWriter::getExchangeCount() const noexcept { return mExchangeCount; }
+
+
+//
+// Reading
+//
+
+std::optional<std::vector<CapturedExchange>> api::v1::readCapture(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    const auto size {file.tellg()};
+    if (size < 0) {
+        return std::nullopt;
+    }
+
+    std::string content(size_t(size), '\0');
+    file.seekg(0);
+    if (!file.read(content.data(), std::streamsize(std::size(content)))) {
+        return std::nullopt;
+    }
+    if (std::string_view(content).substr(0, std::size(CAPTURE_MAGIC)) != CAPTURE_MAGIC) {
+        return std::nullopt;
+    }
+
+    RecordReader reader(std::string_view(content).substr(std::size(CAPTURE_MAGIC)));
+    std::vector<CapturedExchange> exchanges;
+
+    while (!reader.isAtEnd()) {
+        const auto recordSize {reader.getInteger<size_t>(4)};
+        const auto record {reader.getBytes(recordSize)};
+        if (!reader.isValid()) {
+            spdlog::warn("readCapture: ignoring truncated record after {} exchanges", std::size(exchanges));
+            break;
+        }
+
+        auto exchange {decodeExchange(record)};
+        if (!exchange) {
+            spdlog::warn("readCapture: ignoring malformed record after {} exchanges", std::size(exchanges));
+            break;
+        }
+        exchanges.push_back(std::move(exchange.value()));
+    }
+    return exchanges;
+}
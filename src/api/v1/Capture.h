@@ -0,0 +1,81 @@
+/*****************************************************************************/
+/**
+ * @file    Capture.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of the append-only file recording the HTTP exchanges of an Api
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_CAPTURE_H
+#define API_V1_CAPTURE_H
+
+#include "api/v1/Transport.h"
+
+#include <httplib/httplib.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+namespace api::v1 {
+
+    // A request as sent and the response received for it, if any
+    struct CapturedExchange {
+        // Time since the capture has been started, when the request was sent
+        std::chrono::microseconds offset {0};
+
+        std::string method;
+        std::string path;
+        std::string requestBody;
+
+        bool responded {false};
+        int status {-1};
+        httplib::Headers responseHeaders;
+        std::string responseBody;
+
+        RequestTiming timing;
+    };
+
+
+    //
+    // Appends exchanges to a capture file, which starts with a magic line and is followed by one length-prefixed
+    // binary record per exchange. Every record is written in one piece and flushed right away, so an aborted
+    // session loses at most its last exchange. Thread-safe, all connections of an Api share one writer.
+    //
+    class CaptureWriter {
+    public:
+        // Returns nullptr if the file cannot be written
+        static std::shared_ptr<CaptureWriter> open(const std::string &path);
+
+        void append(const httplib::Request &request, const httplib::Response *response, const RequestTiming &timing);
+
+        size_t getExchangeCount() const noexcept;
+
+    private:
+        explicit CaptureWriter(std::ofstream file);
+
+        std::mutex mMutex;
+        std::ofstream mFile;
+        const std::chrono::steady_clock::time_point mOrigin;
+        std::atomic<size_t> mExchangeCount {0};
+
+        // Reused for every record
+        std::string mRecord;
+    };
+
+
+    //
+    // Reads all exchanges of a capture file. Returns std::nullopt if the file cannot be read or is no capture.
+    // A truncated last record, e.g. of a session which got killed while writing it, is ignored.
+    //
+    std::optional<std::vector<CapturedExchange>> readCapture(const std::string &path);
+
+}  // namespace api::v1
+
+#endif
@@ -0,0 +1,125 @@
+/*****************************************************************************/
+/**
+ * @file    Connection.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a (optionally persistent) HTTP connection to the REST API version 1
+ */
+/*****************************************************************************/
+
+#include "Connection.h"
+
+#include <spdlog/spdlog.h>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+// Sending these twice has the same effect as sending them once
+static bool isIdempotent(const std::string &method) {
+    return method == "GET" || method == "HEAD" || method == "PUT" || method == "DELETE" || method == "OPTIONS";
+}
+
+static void addTiming(RequestTiming &total, const RequestTiming &timing) {
+    total.connect += timing.connect;
+    total.send += timing.send;
+    total.wait += timing.wait;
+    total.receive += timing.receive;
+    total.bytesSent += timing.bytesSent;
+    total.bytesReceived += timing.bytesReceived;
+}
+
+
+//
+// Constructors
+//
+
+Connection::Connection(std::unique_ptr<Transport> transport, const bool keepAlive)
+    : mTransport(std::move(transport)), mKeepAlive(keepAlive) {
+    mTransport->setKeepAlive(keepAlive);
+}
+
+
+//
+// Request handling
+//
+
+std::shared_ptr<httplib::Response> Connection::send(const httplib::Request &request, RequestTiming *timing) {
+    std::lock_guard<std::mutex> lock(mSendMutex);
+
+    RequestTiming totalTiming;
+    auto response {sendWithRetry(request, totalTiming)};
+    if (timing) {
+        *timing = totalTiming;
+    }
+    return response;
+}
+
+std::shared_ptr<httplib::Response> Connection::sendWithRetry(const httplib::Request &request,
+                                                             RequestTiming &totalTiming) {
+    const bool reusedSocket {mKeepAlive && mTransport->isOpen()};
+
+    RequestTiming timing;
+    auto response {std::make_shared<httplib::Response>()};
+    const bool sent {mTransport->send(request, *response, timing)};
+    addTiming(totalTiming, timing);
+
+    if (!sent) {
+        // A fresh connection failed, there is nothing left to try. A request which cannot be repeated safely
+        // fails as well, the server might have processed it before the socket broke.
+        if (!reusedSocket || !isIdempotent(request.method)) {
+            return nullptr;
+        }
+
+        // The server most likely closed the idle keep-alive socket
+        spdlog::debug("Connection::send: reconnecting after stale keep-alive socket");
+        ++mReconnects;
+
+        response = std::make_shared<httplib::Response>();
+        const bool resent {mTransport->send(request, *response, timing)};
+        addTiming(totalTiming, timing);
+
+        if (!resent) {
+            return nullptr;
+        }
+    }
+
+    ++mRequestsServed;
+    return response;
+}
+
+
+//
+// Settings and statistics
+//
+
+void Connection::setKeepAlive(const bool keepAlive) {
+    std::lock_guard<std::mutex> lock(mSendMutex);
+
+    mKeepAlive = keepAlive;
+    mTransport->setKeepAlive(keepAlive);
+    if (!keepAlive) {
+        mTransport->close();
+    }
+}
+
+bool Connection::isKeepAlive() const noexcept { return mKeepAlive; }
+
+
+ConnectionStats Connection::getStats() const noexcept {
+    ConnectionStats stats;
+    stats.connectionsOpened = mTransport->getConnectionsOpened();
+    stats.requestsServed    = mRequestsServed;
+    stats.reconnects        = mReconnects;
+    return stats;
+}
+
+
+void Connection::resetStats() noexcept {
+    mTransport->resetConnectionsOpened();
+    mRequestsServed = 0;
+    mReconnects     = 0;
+}
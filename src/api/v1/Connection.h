@@ -0,0 +1,65 @@
+/*****************************************************************************/
+/**
+ * @file    Connection.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a (optionally persistent) HTTP connection to the REST API version 1
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_CONNECTION_H
+#define API_V1_CONNECTION_H
+
+#include "api/v1/Transport.h"
+
+#include <httplib/httplib.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+
+namespace api::v1 {
+
+    struct ConnectionStats {
+        size_t connectionsOpened {0};
+        size_t requestsServed {0};
+        size_t reconnects {0};
+    };
+
+
+    class Connection {
+    public:
+        explicit Connection(std::unique_ptr<Transport> transport, const bool keepAlive = true);
+
+        Connection(const Connection &) = delete;
+        Connection &operator=(const Connection &) = delete;
+
+        //
+        // Sends the request and returns the response or nullptr if the server could not be reached.
+        // If a reused keep-alive socket turns out to be closed by the server, idempotent requests are
+        // retried once on a freshly opened connection. Others (e.g. POST) may have reached the server
+        // already and fail instead. Concurrent calls are serialized; the timing of the exchange
+        // (including a retry) is stored in the optional out parameter.
+        //
+        std::shared_ptr<httplib::Response> send(const httplib::Request &request, RequestTiming *timing = nullptr);
+
+        void setKeepAlive(const bool keepAlive);
+        bool isKeepAlive() const noexcept;
+
+        ConnectionStats getStats() const noexcept;
+        void resetStats() noexcept;
+
+    private:
+        std::shared_ptr<httplib::Response> sendWithRetry(const httplib::Request &request, RequestTiming &timing);
+
+        std::unique_ptr<Transport> mTransport;
+        std::mutex mSendMutex;
+        std::atomic_bool mKeepAlive;
+
+        std::atomic<size_t> mRequestsServed {0};
+        std::atomic<size_t> mReconnects {0};
+    };
+
+}  // namespace api::v1
+
+#endif
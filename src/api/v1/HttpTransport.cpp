@@ -0,0 +1,369 @@
+/*****************************************************************************/
+/**
+ * @file    HttpTransport.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of the transports sending HTTP requests over TCP or Unix domain sockets
+ */
+/*****************************************************************************/
+
+#include "HttpTransport.h"
+
+#include <httplib/httplib.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+
+using namespace api::v1;
+
+
+//
+// Socket stream, which timestamps the first and last reads and writes of an exchange
+//
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Writing to a socket the server already closed must fail (and be retried) instead of raising SIGPIPE, which
+    // would terminate any program using this library. Where the flag is missing, SO_NOSIGPIPE is set instead.
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS {MSG_NOSIGNAL};
+#else
+    constexpr int SEND_FLAGS {0};
+#endif
+
+    struct ExchangeTimestamps {
+        std::optional<Clock::time_point> firstWriteStart;
+        std::optional<Clock::time_point> lastWriteEnd;
+        std::optional<Clock::time_point> firstReadEnd;
+        std::optional<Clock::time_point> lastReadEnd;
+        size_t bytesSent {0};
+        size_t bytesReceived {0};
+    };
+
+    struct Timeout {
+        time_t sec;
+        time_t usec;
+    };
+
+    //
+    // Takes the place of httplib's own socket stream (which it does not expose), so that the exchange can be
+    // measured at the socket without changing httplib itself. Reads and writes time out the way httplib's do.
+    //
+    class TimingSocketStream : public httplib::Stream {
+    public:
+        TimingSocketStream(const socket_t sock, const Timeout readTimeout, const Timeout writeTimeout,
+                           ExchangeTimestamps &timestamps)
+            : mSock(sock), mReadTimeout(readTimeout), mWriteTimeout(writeTimeout), mTimestamps(timestamps) {}
+
+        bool is_readable() const override { return waitFor(POLLIN, mReadTimeout); }
+        bool is_writable() const override { return waitFor(POLLOUT, mWriteTimeout); }
+
+        ssize_t read(char *ptr, size_t size) override {
+            if (!is_readable()) {
+                return -1;
+            }
+
+            const auto result {receive(ptr, size)};
+            if (result > 0) {
+                const auto now {Clock::now()};
+                if (!mTimestamps.firstReadEnd) {
+                    mTimestamps.firstReadEnd = now;
+                }
+                mTimestamps.lastReadEnd = now;
+                mTimestamps.bytesReceived += size_t(result);
+            }
+            return result;
+        }
+
+        ssize_t write(const char *ptr, size_t size) override {
+            if (!mTimestamps.firstWriteStart) {
+                mTimestamps.firstWriteStart = Clock::now();
+            }
+            if (!is_writable()) {
+                return -1;
+            }
+
+            const auto result {transmit(ptr, size)};
+            if (result > 0) {
+                mTimestamps.lastWriteEnd = Clock::now();
+                mTimestamps.bytesSent += size_t(result);
+            }
+            return result;
+        }
+
+        void get_remote_ip_and_port(std::string &ip, int &port) const override {
+            sockaddr_storage address {};
+            socklen_t addressLength {sizeof(address)};
+            std::array<char, NI_MAXHOST> host {};
+            std::array<char, NI_MAXSERV> service {};
+
+            if (::getpeername(mSock, reinterpret_cast<sockaddr *>(&address), &addressLength) != 0
+                || ::getnameinfo(reinterpret_cast<sockaddr *>(&address), addressLength, host.data(),
+                                 socklen_t(std::size(host)), service.data(), socklen_t(std::size(service)),
+                                 NI_NUMERICHOST | NI_NUMERICSERV)
+                       != 0) {
+                return;
+            }
+            ip   = host.data();
+            port = std::atoi(service.data());
+        }
+
+    private:
+        bool waitFor(const short events, const Timeout timeout) const {
+            pollfd fd {};
+            fd.fd     = mSock;
+            fd.events = events;
+
+            const auto timeoutMs {int(timeout.sec * 1000 + timeout.usec / 1000)};
+#ifdef _WIN32
+            return ::WSAPoll(&fd, 1, timeoutMs) > 0;
+#else
+            int result;
+            do {
+                result = ::poll(&fd, 1, timeoutMs);
+            } while (result < 0 && errno == EINTR);
+            return result > 0;
+#endif
+        }
+
+        ssize_t receive(char *ptr, const size_t size) const {
+#ifdef _WIN32
+            return ::recv(mSock, ptr, int(std::min<size_t>(size, INT_MAX)), 0);
+#else
+            ssize_t result;
+            do {
+                result = ::recv(mSock, ptr, size, 0);
+            } while (result < 0 && errno == EINTR);
+            return result;
+#endif
+        }
+
+        ssize_t transmit(const char *ptr, const size_t size) const {
+#ifdef _WIN32
+            return ::send(mSock, ptr, int(std::min<size_t>(size, INT_MAX)), 0);
+#else
+            ssize_t result;
+            do {
+                result = ::send(mSock, ptr, size, SEND_FLAGS);
+            } while (result < 0 && errno == EINTR);
+            return result;
+#endif
+        }
+
+        const socket_t mSock;
+        const Timeout mReadTimeout;
+        const Timeout mWriteTimeout;
+        ExchangeTimestamps &mTimestamps;
+    };
+
+    //
+    // httplib reads a body for every response, but responses with these statuses never have one (RFC 7230, 3.3.3).
+    // A 304 without Content-Length, or repeating the one of the full response, would otherwise be read until the
+    // read timeout. Called once the headers are read, so the response is still being built by httplib.
+    //
+    bool skipBodyOfBodilessResponse(const httplib::Response &response) {
+        const auto status {response.status};
+        if ((status >= 100 && status < 200) || status == 204 || status == 304) {
+            auto &headers {const_cast<httplib::Response &>(response).headers};
+            headers.erase("Transfer-Encoding");
+            headers.erase("Content-Length");
+            headers.emplace("Content-Length", "0");
+        }
+        return true;
+    }
+
+    std::chrono::microseconds elapsed(const std::optional<Clock::time_point> &from,
+                                      const std::optional<Clock::time_point> &to) {
+        if (!from || !to) {
+            return std::chrono::microseconds(0);
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(to.value() - from.value());
+    }
+
+}  // namespace
+
+
+//
+// httplib::Client which keeps track of the sockets it opens and of the timing of each exchange
+//
+
+class HttpTransport::InstrumentedClient : public httplib::Client {
+public:
+    InstrumentedClient(const std::string &address, const unsigned int port, std::optional<std::string> socketPath)
+        : httplib::Client(address, int(port)), mSocketPath(std::move(socketPath)) {}
+
+    size_t getConnectionsOpened() const noexcept { return mConnectionsOpened; }
+    void resetConnectionsOpened() noexcept { mConnectionsOpened = 0; }
+
+    void resetTiming() noexcept { mTiming = RequestTiming(); }
+
+    //
+    // An idle keep-alive socket has nothing to read, unless the server closed it in the meantime (end of file
+    // or reset). Closing it before writing lets any request, including non-idempotent ones, go out on a fresh
+    // connection instead of failing after it may have reached the server.
+    //
+    void closeIfStale() {
+#ifndef _WIN32
+        bool stale {false};
+        {
+            std::lock_guard<std::mutex> lock(socket_mutex_);
+            if (!socket_.is_open()) {
+                return;
+            }
+
+            pollfd fd {};
+            fd.fd     = socket_.sock;
+            fd.events = POLLIN;
+            stale     = ::poll(&fd, 1, 0) != 0;
+        }
+
+        if (stale) {
+            stop();
+        }
+#endif
+    }
+    const RequestTiming &getTiming() const noexcept { return mTiming; }
+
+protected:
+    bool create_and_connect_socket(Socket &socket) override {
+        const auto start {Clock::now()};
+        const bool connected {mSocketPath ? connectUnixSocket(socket)
+                                          : httplib::Client::create_and_connect_socket(socket)};
+        mTiming.connect += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+        if (!connected) {
+            return false;
+        }
+
+#ifdef SO_NOSIGPIPE
+        const int noSigPipe {1};
+        ::setsockopt(socket.sock, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+
+        ++mConnectionsOpened;
+        return true;
+    }
+
+    // Overrides a private virtual of httplib::Client, which is only ever called by the client itself
+    bool process_socket(Socket &socket, std::function<bool(httplib::Stream &strm)> callback) override {
+        ExchangeTimestamps timestamps;
+        TimingSocketStream stream(socket.sock, {read_timeout_sec_, read_timeout_usec_},
+                                  {write_timeout_sec_, write_timeout_usec_}, timestamps);
+        const bool result {callback(stream)};
+
+        mTiming.send += elapsed(timestamps.firstWriteStart, timestamps.lastWriteEnd);
+        mTiming.wait += elapsed(timestamps.lastWriteEnd, timestamps.firstReadEnd);
+        mTiming.receive += elapsed(timestamps.firstReadEnd, timestamps.lastReadEnd);
+        mTiming.bytesSent += timestamps.bytesSent;
+        mTiming.bytesReceived += timestamps.bytesReceived;
+        return result;
+    }
+
+private:
+    bool connectUnixSocket(Socket &socket) const {
+#ifndef _WIN32
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        if (std::size(mSocketPath.value()) >= sizeof(address.sun_path)) {
+            return false;
+        }
+        std::memcpy(address.sun_path, mSocketPath->c_str(), std::size(mSocketPath.value()) + 1);
+
+        const auto sock {::socket(AF_UNIX, SOCK_STREAM, 0)};
+        if (sock < 0) {
+            return false;
+        }
+        if (::connect(sock, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            ::close(sock);
+            return false;
+        }
+
+        socket.sock = sock;
+        return true;
+#else
+        static_cast<void>(socket);
+        return false;
+#endif
+    }
+
+    const std::optional<std::string> mSocketPath;
+    std::atomic<size_t> mConnectionsOpened {0};
+    RequestTiming mTiming;
+};
+
+
+//
+// Constructors
+//
+
+HttpTransport::HttpTransport(const std::string &address, const unsigned int port)
+    : HttpTransport(address, port, std::nullopt) {}
+
+HttpTransport::HttpTransport(const std::string &address, const unsigned int port,
+                             std::optional<std::string> socketPath)
+    : mClient(std::make_unique<InstrumentedClient>(address, port, std::move(socketPath))) {
+
+    // httplib writes headers and body separately, Nagle's algorithm would hold the body back until the
+    // (delayed) ACK of the headers arrives
+    mClient->set_tcp_nodelay(true);
+}
+
+HttpTransport::~HttpTransport() { mClient->stop(); }
+
+// The Host header still names a host, any will do for a server listening on a socket file
+UnixSocketTransport::UnixSocketTransport(const std::string &socketPath)
+    : HttpTransport("localhost", 80, socketPath) {}
+
+
+//
+// Exchanges
+//
+
+bool HttpTransport::send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) {
+    mClient->closeIfStale();
+    mClient->resetTiming();
+
+    bool sent;
+    if (request.response_handler) {
+        sent = mClient->send(request, response);
+    } else {
+        auto bodilessAware {request};
+        bodilessAware.response_handler = skipBodyOfBodilessResponse;
+        sent = mClient->send(bodilessAware, response);
+    }
+    timing = mClient->getTiming();
+
+    if (!sent) {
+        mClient->stop();
+    }
+    return sent;
+}
+
+bool HttpTransport::isOpen() const { return mClient->is_socket_open(); }
+
+void HttpTransport::close() { mClient->stop(); }
+
+void HttpTransport::setKeepAlive(const bool keepAlive) { mClient->set_keep_alive(keepAlive); }
+
+
+//
+// Statistics
+//
+
+size_t HttpTransport::getConnectionsOpened() const noexcept { return mClient->getConnectionsOpened(); }
+
+void HttpTransport::resetConnectionsOpened() noexcept { mClient->resetConnectionsOpened(); }
@@ -0,0 +1,62 @@
+/*****************************************************************************/
+/**
+ * @file    HttpTransport.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of the transports sending HTTP requests over TCP or Unix domain sockets
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_HTTP_TRANSPORT_H
+#define API_V1_HTTP_TRANSPORT_H
+
+#include "api/v1/Transport.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+
+
+namespace api::v1 {
+
+    // A httplib::Client, which keeps track of the sockets it opens and of the timing of each exchange
+    class HttpTransport : public Transport {
+    public:
+        HttpTransport(const std::string &address, const unsigned int port);
+        ~HttpTransport() override;
+
+        HttpTransport(const HttpTransport &) = delete;
+        HttpTransport &operator=(const HttpTransport &) = delete;
+
+        bool send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) override;
+
+        bool isOpen() const override;
+        void close() override;
+
+        void setKeepAlive(const bool keepAlive) override;
+
+        size_t getConnectionsOpened() const noexcept override;
+        void resetConnectionsOpened() noexcept override;
+
+    protected:
+        // Connects to the socket at the given path instead of the address, if there is one
+        HttpTransport(const std::string &address, const unsigned int port, std::optional<std::string> socketPath);
+
+    private:
+        class InstrumentedClient;
+
+        std::unique_ptr<InstrumentedClient> mClient;
+    };
+
+
+    //
+    // Speaks HTTP over a Unix domain socket, e.g. to a server or proxy on the same host. Saves the TCP handshake
+    // and the loopback network stack, but nothing else.
+    //
+    class UnixSocketTransport : public HttpTransport {
+    public:
+        explicit UnixSocketTransport(const std::string &socketPath);
+    };
+
+}  // namespace api::v1
+
+#endif
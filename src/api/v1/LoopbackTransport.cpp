@@ -0,0 +1,98 @@
+/*****************************************************************************/
+/**
+ * @file    LoopbackTransport.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a transport handing requests to a server-side handler in the same process
+ */
+/*****************************************************************************/
+
+#include "LoopbackTransport.h"
+#include "endpoint.h"
+
+#include <spdlog/spdlog.h>
+
+#include <string_view>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+// Query parameters are decoded like httplib::Server does, the client percent-encodes them
+static void splitQuery(httplib::Request &request) {
+    const auto queryStart {request.path.find('?')};
+    if (queryStart == std::string::npos) {
+        return;
+    }
+
+    std::string_view query(request.path);
+    query.remove_prefix(queryStart + 1);
+
+    while (!query.empty()) {
+        const auto parameterEnd {std::min(query.find('&'), std::size(query))};
+        const auto parameter {query.substr(0, parameterEnd)};
+
+        const auto separatorPos {parameter.find('=')};
+        if (separatorPos != std::string_view::npos) {
+            request.params.emplace(decodeQueryValue(parameter.substr(0, separatorPos)),
+                                   decodeQueryValue(parameter.substr(separatorPos + 1)));
+        } else if (!parameter.empty()) {
+            request.params.emplace(decodeQueryValue(parameter), "");
+        }
+
+        query.remove_prefix(std::min(parameterEnd + 1, std::size(query)));
+    }
+    request.path.erase(queryStart);
+}
+
+
+//
+// Constructors
+//
+
+LoopbackTransport::LoopbackTransport(RequestHandler handler) : mHandler(std::move(handler)) {}
+
+
+//
+// Exchanges
+//
+
+bool LoopbackTransport::send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) {
+    auto serverRequest {request};
+    splitQuery(serverRequest);
+
+    const auto start {std::chrono::steady_clock::now()};
+    try {
+        mHandler(serverRequest, response);
+    } catch (const std::exception &ex) {
+        spdlog::debug("LoopbackTransport::send: handler failed, {}", ex.what());
+        response        = httplib::Response();
+        response.status = 500;
+    }
+
+    timing      = RequestTiming();
+    timing.wait = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    if (response.status == -1) {
+        response.status = 200;
+    }
+    return true;
+}
+
+bool LoopbackTransport::isOpen() const { return false; }
+
+void LoopbackTransport::close() {}
+
+void LoopbackTransport::setKeepAlive(const bool) {}
+
+
+//
+// Statistics
+//
+
+size_t LoopbackTransport::getConnectionsOpened() const noexcept { return 0; }
+
+void LoopbackTransport::resetConnectionsOpened() noexcept {}
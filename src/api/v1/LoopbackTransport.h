@@ -0,0 +1,53 @@
+/*****************************************************************************/
+/**
+ * @file    LoopbackTransport.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a transport handing requests to a server-side handler in the same process
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_LOOPBACK_TRANSPORT_H
+#define API_V1_LOOPBACK_TRANSPORT_H
+
+#include "api/v1/Transport.h"
+
+#include <functional>
+
+
+namespace api::v1 {
+
+    // Answers a request like a server would, e.g. mock::Jukebox::handle
+    using RequestHandler = std::function<void(const httplib::Request &, httplib::Response &)>;
+
+
+    //
+    // Calls the handler directly instead of sending anything over a network. The request is prepared the way
+    // httplib::Server would hand it to its handlers (path and query parameters split), everything else is left
+    // to the client and the handler. This isolates the CPU cost of building requests, parsing responses and
+    // rendering their results from any network effects.
+    //
+    // The whole handler runs as the wait phase of the exchange, nothing is sent or received. Exceptions escaping the
+    // handler are answered with status 500, as httplib::Server does.
+    //
+    class LoopbackTransport : public Transport {
+    public:
+        explicit LoopbackTransport(RequestHandler handler);
+
+        bool send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) override;
+
+        // There is no channel to keep open, so failed exchanges are never retried
+        bool isOpen() const override;
+        void close() override;
+
+        void setKeepAlive(const bool keepAlive) override;
+
+        size_t getConnectionsOpened() const noexcept override;
+        void resetConnectionsOpened() noexcept override;
+
+    private:
+        RequestHandler mHandler;
+    };
+
+}  // namespace api::v1
+
+#endif
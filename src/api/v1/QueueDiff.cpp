@@ -0,0 +1,147 @@
+/*****************************************************************************/
+/**
+ * @file    QueueDiff.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of the differences between two states of the queues of the REST API version 1
+ */
+/*****************************************************************************/
+
+#include "QueueDiff.h"
+
+#include <algorithm>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+//
+// Returns for every entry, whether it belongs to a longest increasing subsequence.
+// Entries outside of it are the fewest ones which need to be moved to restore the order of the others.
+//
+static std::vector<bool> markLongestIncreasingSubsequence(const std::vector<size_t> &values) {
+    // tails[l] is the index of the smallest value ending an increasing subsequence of length l + 1
+    std::vector<size_t> tails;
+    std::vector<size_t> predecessors(std::size(values));
+
+    for (size_t i {0}; i < std::size(values); ++i) {
+        const auto tailIt {std::lower_bound(std::cbegin(tails), std::cend(tails), values[i],
+                                            [&](const size_t index, const size_t value) {
+                                                return values[index] < value;
+                                            })};
+        predecessors[i] = tailIt == std::cbegin(tails) ? i : *(tailIt - 1);
+
+        if (tailIt == std::cend(tails)) {
+            tails.push_back(i);
+        } else {
+            tails[size_t(tailIt - std::cbegin(tails))] = i;
+        }
+    }
+
+    std::vector<bool> inSubsequence(std::size(values), false);
+    if (!tails.empty()) {
+        for (auto i {tails.back()};; i = predecessors[i]) {
+            inSubsequence[i] = true;
+            if (predecessors[i] == i) {
+                break;
+            }
+        }
+    }
+    return inSubsequence;
+}
+
+template<typename Track>
+static void diffQueue(const std::vector<Track> &from, const std::vector<Track> &to, const QueueType queueType,
+                      std::vector<QueueChange> &changes) {
+    constexpr bool HAS_VOTES {std::is_same_v<Track, NormalQueueTrack>};
+
+    std::unordered_map<std::string_view, size_t> oldPositions;
+    oldPositions.reserve(std::size(from));
+    for (size_t i {0}; i < std::size(from); ++i) {
+        oldPositions.emplace(from[i].trackId, i);
+    }
+
+    // Old position of every track of the new queue, if it has been part of the old one as well
+    std::vector<std::optional<size_t>> matches(std::size(to));
+    std::vector<bool> matched(std::size(from), false);
+    std::vector<size_t> commonOldPositions;
+    for (size_t i {0}; i < std::size(to); ++i) {
+        const auto oldIt {oldPositions.find(to[i].trackId)};
+        if (oldIt != oldPositions.cend() && !matched[oldIt->second]) {
+            matches[i]             = oldIt->second;
+            matched[oldIt->second] = true;
+            commonOldPositions.push_back(oldIt->second);
+        }
+    }
+
+    for (size_t i {0}; i < std::size(from); ++i) {
+        if (!matched[i]) {
+            QueueChange change {QueueChangeType::REMOVED, queueType, from[i], i, std::nullopt};
+            if constexpr (HAS_VOTES) {
+                change.oldVotes = from[i].votes;
+            }
+            changes.push_back(std::move(change));
+        }
+    }
+
+    const auto inOrder {markLongestIncreasingSubsequence(commonOldPositions)};
+    size_t commonIndex {0};
+    for (size_t i {0}; i < std::size(to); ++i) {
+        if (!matches[i]) {
+            QueueChange change {QueueChangeType::ADDED, queueType, to[i], std::nullopt, i};
+            if constexpr (HAS_VOTES) {
+                change.newVotes = to[i].votes;
+            }
+            changes.push_back(std::move(change));
+            continue;
+        }
+
+        const auto oldPosition {matches[i].value()};
+        const bool moved {!inOrder[commonIndex++]};
+        bool votesChanged {false};
+        if constexpr (HAS_VOTES) {
+            votesChanged = from[oldPosition].votes != to[i].votes;
+        }
+
+        if (moved || votesChanged) {
+            QueueChange change {QueueChangeType::CHANGED, queueType, to[i], oldPosition, i};
+            change.moved = moved;
+            if constexpr (HAS_VOTES) {
+                change.oldVotes = from[oldPosition].votes;
+                change.newVotes = to[i].votes;
+            }
+            changes.push_back(std::move(change));
+        }
+    }
+}
+
+
+//
+// Diff
+//
+
+QueuesDiff api::v1::diffQueues(const Queues &from, const Queues &to) {
+    QueuesDiff diff;
+
+    const auto &previous {from.currentlyPlaying};
+    const auto &current {to.currentlyPlaying};
+    if (previous.has_value() != current.has_value()) {
+        diff.playingChanged = true;
+    } else if (previous && current) {
+        diff.playingChanged = previous->trackId != current->trackId || previous->playing != current->playing;
+    }
+    if (diff.playingChanged) {
+        diff.previouslyPlaying = previous;
+        diff.currentlyPlaying  = current;
+    }
+
+    diffQueue(from.adminQueue, to.adminQueue, QueueType::ADMIN, diff.changes);
+    diffQueue(from.normalQueue, to.normalQueue, QueueType::NORMAL, diff.changes);
+    return diff;
+}
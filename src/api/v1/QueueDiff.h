@@ -0,0 +1,63 @@
+/*****************************************************************************/
+/**
+ * @file    QueueDiff.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of the differences between two states of the queues of the REST API version 1
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_QUEUE_DIFF_H
+#define API_V1_QUEUE_DIFF_H
+
+#include "api/v1/ApiTypes.h"
+
+#include <optional>
+#include <vector>
+
+
+namespace api::v1 {
+
+    enum class QueueChangeType { ADDED, REMOVED, CHANGED };
+
+    struct QueueChange {
+        QueueChangeType type;
+        QueueType queue;
+
+        // The track as found in the newer queues, or in the older ones if it has been removed
+        QueueTrack track;
+
+        // Zero based; only the positions of the queues the track is part of are set
+        std::optional<size_t> oldPosition;
+        std::optional<size_t> newPosition;
+
+        // Moved relative to the other tracks, a shift caused by adding or removing tracks is no move
+        bool moved {false};
+
+        // Only set for the normal queue
+        int oldVotes {0};
+        int newVotes {0};
+    };
+
+    struct QueuesDiff {
+        // Set if another track is playing or playback has been paused or resumed
+        bool playingChanged {false};
+        std::optional<PlayingTrack> previouslyPlaying;
+        std::optional<PlayingTrack> currentlyPlaying;
+
+        // Removed tracks first in their old order, followed by the others in their new order; per queue
+        std::vector<QueueChange> changes;
+
+        bool empty() const noexcept { return !playingChanged && changes.empty(); }
+    };
+
+
+    //
+    // Compares two states of the queues, matching tracks by their id.
+    // The work is linear in the size of the queues, apart from telling moves from shifts, which takes O(n log n)
+    // in the number of tracks in both states. The result only grows with the number of changes.
+    //
+    QueuesDiff diffQueues(const Queues &from, const Queues &to);
+
+}  // namespace api::v1
+
+#endif
@@ -0,0 +1,158 @@
+/*****************************************************************************/
+/**
+ * @file    QueuePoller.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a background thread keeping the queues of the REST API version 1 up to date
+ */
+/*****************************************************************************/
+
+#include "QueuePoller.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+// The playing progress is ignored, it changes with every poll while a track is playing
+static bool isSameQueue(const Queues &lhs, const Queues &rhs) {
+    const auto sameTrack {[](const BaseTrack &t1, const BaseTrack &t2) { return t1.trackId == t2.trackId; }};
+    const auto sameNormalTrack {[](const NormalQueueTrack &t1, const NormalQueueTrack &t2) {
+        return t1.trackId == t2.trackId && t1.votes == t2.votes && t1.currentVote == t2.currentVote;
+    }};
+
+    if (lhs.currentlyPlaying.has_value() != rhs.currentlyPlaying.has_value()) {
+        return false;
+    }
+    if (lhs.currentlyPlaying
+        && (lhs.currentlyPlaying->trackId != rhs.currentlyPlaying->trackId
+            || lhs.currentlyPlaying->playing != rhs.currentlyPlaying->playing)) {
+        return false;
+    }
+
+    return std::equal(std::cbegin(lhs.normalQueue), std::cend(lhs.normalQueue), std::cbegin(rhs.normalQueue),
+                      std::cend(rhs.normalQueue), sameNormalTrack)
+           && std::equal(std::cbegin(lhs.adminQueue), std::cend(lhs.adminQueue), std::cbegin(rhs.adminQueue),
+                         std::cend(rhs.adminQueue), sameTrack);
+}
+
+
+//
+// Construction and destruction
+//
+
+QueuePoller::QueuePoller(Fetch fetch, const QueuePollerConfig &config)
+    : mFetch(std::move(fetch)), mConfig(config), mThread(&QueuePoller::run, this) {}
+
+QueuePoller::~QueuePoller() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWakeUp.notify_all();
+    mThread.join();
+}
+
+
+//
+// Accessors
+//
+
+void QueuePoller::refresh() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRefreshRequested = true;
+    }
+    mWakeUp.notify_all();
+}
+
+QueuePollerStats QueuePoller::getStats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+QueuePollerConfig QueuePoller::getConfig() const noexcept { return mConfig; }
+
+
+//
+// Polling
+//
+
+std::chrono::milliseconds QueuePoller::computeInterval(const QueuePollerConfig &config, const Queues *queues,
+                                                       const size_t unchangedPolls) {
+    const auto minInterval {std::max(config.minInterval, std::chrono::milliseconds(1))};
+    auto maxInterval {std::max(config.maxInterval, minInterval)};
+
+    if (queues && queues->currentlyPlaying && queues->currentlyPlaying->playing) {
+        const auto &playing {queues->currentlyPlaying.value()};
+        const std::chrono::milliseconds remaining {std::max(playing.duration - playing.playingFor, 0)};
+
+        // The next track starts any moment
+        if (remaining <= config.changeWindow) {
+            return minInterval;
+        }
+
+        // Wake up in time to catch the beginning of the change window
+        maxInterval = std::clamp(remaining - config.changeWindow, minInterval, maxInterval);
+    }
+
+    // Double the interval for every poll without changes
+    auto interval {minInterval};
+    for (size_t i {0}; i < unchangedPolls && interval < maxInterval; ++i) {
+        interval *= 2;
+    }
+    return std::min(interval, maxInterval);
+}
+
+void QueuePoller::run() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (!mStopping) {
+        lock.unlock();
+        poll();
+        lock.lock();
+
+        const auto interval {computeInterval(mConfig, mLastSnapshot ? mLastSnapshot->queues.get() : nullptr,
+                                             mUnchangedPolls)};
+        mStats.interval = interval;
+
+        mWakeUp.wait_for(lock, interval, [this] { return mStopping || mRefreshRequested; });
+        mRefreshRequested = false;
+    }
+}
+
+void QueuePoller::poll() {
+    try {
+        auto snapshot {mFetch()};
+
+        // The same version of the same store means the very same queues, only newer versions need to be compared
+        const auto unchanged {mLastSnapshot
+                              && ((mLastSnapshot->storeId == snapshot->storeId
+                                   && mLastSnapshot->version == snapshot->version)
+                                  || isSameQueue(*mLastSnapshot->queues, *snapshot->queues))};
+        mLastSnapshot = std::move(snapshot);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mStats.polls;
+        if (unchanged) {
+            ++mUnchangedPolls;
+        } else {
+            ++mStats.changes;
+            mUnchangedPolls = 0;
+        }
+    } catch (const std::exception &e) {
+        spdlog::debug("QueuePoller::poll: {}", e.what());
+
+        // Keep the last queues, but do not hammer a failing server
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mStats.polls;
+        ++mStats.errors;
+        ++mUnchangedPolls;
+        mStats.lastError = e.what();
+    }
+}
@@ -0,0 +1,92 @@
+/*****************************************************************************/
+/**
+ * @file    QueuePoller.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a background thread keeping the queues of the REST API version 1 up to date
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_QUEUE_POLLER_H
+#define API_V1_QUEUE_POLLER_H
+
+#include "api/v1/ApiTypes.h"
+#include "api/v1/QueuesStore.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+
+namespace api::v1 {
+
+    struct QueuePollerConfig {
+        std::chrono::milliseconds minInterval {500};
+        std::chrono::milliseconds maxInterval {15000};
+
+        // Polls with the minimum interval once the playing track ends within this window
+        std::chrono::milliseconds changeWindow {3000};
+    };
+
+    struct QueuePollerStats {
+        size_t polls {0};
+        size_t changes {0};
+        size_t errors {0};
+        std::chrono::milliseconds interval {0};
+        std::string lastError;
+    };
+
+
+    //
+    // Polls the queues on its own thread. The fetch function is expected to publish the result, e.g. in a QueuesStore.
+    // The interval follows the playing track: it is short just before the track changes and grows while nothing
+    // changes, up to the time left until the next track change (or the maximum interval).
+    //
+    class QueuePoller {
+    public:
+        using Fetch = std::function<std::shared_ptr<const QueuesSnapshot>()>;
+        using Clock = std::chrono::steady_clock;
+
+        QueuePoller(Fetch fetch, const QueuePollerConfig &config = {});
+        ~QueuePoller();
+
+        QueuePoller(const QueuePoller &) = delete;
+        QueuePoller &operator=(const QueuePoller &) = delete;
+
+        // Polls again right away, e.g. after the queues have been changed by this client
+        void refresh();
+
+        QueuePollerStats getStats() const;
+        QueuePollerConfig getConfig() const noexcept;
+
+        // Time until the next poll after the given queues have been fetched
+        static std::chrono::milliseconds computeInterval(const QueuePollerConfig &config, const Queues *queues,
+                                                         const size_t unchangedPolls);
+
+    private:
+        void run();
+        void poll();
+
+        const Fetch mFetch;
+        const QueuePollerConfig mConfig;
+
+        mutable std::mutex mMutex;
+        std::condition_variable mWakeUp;
+        bool mStopping {false};
+        bool mRefreshRequested {false};
+
+        // Result of the last successful poll, only accessed by the polling thread
+        std::shared_ptr<const QueuesSnapshot> mLastSnapshot;
+        size_t mUnchangedPolls {0};
+        QueuePollerStats mStats;
+
+        // Started last, once everything it accesses is initialized
+        std::thread mThread;
+    };
+
+}  // namespace api::v1
+
+#endif
@@ -0,0 +1,64 @@
+/*****************************************************************************/
+/**
+ * @file    QueuesStore.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of versioned, immutable snapshots of the queues shared between threads
+ */
+/*****************************************************************************/
+
+#include "QueuesStore.h"
+
+#include <atomic>
+
+
+using namespace api::v1;
+
+
+// Unique within the process, so that snapshots of different Api instances are never mistaken for each other
+static uint64_t generateStoreId() {
+    static std::atomic<uint64_t> nextStoreId {1};
+    return nextStoreId++;
+}
+
+
+std::chrono::milliseconds QueuesSnapshot::getAge(const Clock::time_point now) const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now - fetchedAt);
+}
+
+
+QueuesStore::QueuesStore() : mStoreId(generateStoreId()) {}
+
+std::shared_ptr<const QueuesSnapshot> QueuesStore::load() const { return std::atomic_load(&mSnapshot); }
+
+std::shared_ptr<const QueuesSnapshot> QueuesStore::publish(std::shared_ptr<const Queues> queues,
+                                                           const QueuesSnapshot::Clock::time_point fetchedAt,
+                                                           std::shared_ptr<const Queues> receivedQueues) {
+    auto current {std::atomic_load(&mSnapshot)};
+
+    auto next {std::make_shared<QueuesSnapshot>()};
+    next->storeId        = mStoreId;
+    next->fetchedAt      = fetchedAt;
+    next->receivedQueues = receivedQueues ? std::move(receivedQueues) : queues;
+    next->queues         = std::move(queues);
+
+    // Retried until no other writer published in between; the new snapshot is not visible yet and may be adjusted
+    do {
+        if (current && current->fetchedAt > fetchedAt) {
+            return current;
+        }
+        if (!current) {
+            next->version = 1;
+        } else if (current->receivedQueues == next->receivedQueues) {
+            next->version = current->version;
+        } else {
+            next->version = current->version + 1;
+        }
+    } while (!std::atomic_compare_exchange_weak(&mSnapshot, &current, std::shared_ptr<const QueuesSnapshot>(next)));
+
+    return next;
+}
+
+void QueuesStore::clear() {
+    mStoreId = generateStoreId();
+    std::atomic_store(&mSnapshot, std::shared_ptr<const QueuesSnapshot>());
+}
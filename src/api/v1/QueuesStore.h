@@ -0,0 +1,84 @@
+/*****************************************************************************/
+/**
+ * @file    QueuesStore.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of versioned, immutable snapshots of the queues shared between threads
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_QUEUES_STORE_H
+#define API_V1_QUEUES_STORE_H
+
+#include "api/v1/ApiTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+
+namespace api::v1 {
+
+    struct QueuesSnapshot {
+        using Clock = std::chrono::steady_clock;
+
+        // Identifies the store which published the snapshot, versions of different stores cannot be compared
+        uint64_t storeId {0};
+
+        // Increases whenever different queues are published, a revalidation of the same queues keeps it
+        uint64_t version {0};
+
+        // When the request has been sent, the queues show every change completed before
+        Clock::time_point fetchedAt;
+        std::shared_ptr<const Queues> queues;
+
+        // The queues as received from the server, before the progress of the playing track has been extrapolated
+        std::shared_ptr<const Queues> receivedQueues;
+
+        std::chrono::milliseconds getAge(const Clock::time_point now = Clock::now()) const;
+    };
+
+
+    //
+    // Holds the most recent snapshot of the queues.
+    // Snapshots are never modified once published, so readers only copy a pointer and may keep using their snapshot
+    // for as long as they like, while writers build the next one on the side and swap it in.
+    //
+    // This is not lock-free: the atomic shared_ptr functions of libstdc++ and libc++ guard every access with a mutex
+    // from a small pool, so loads and publishes briefly serialize. The lock only covers the copy of the pointer,
+    // never a request or the parsing of a response, so readers still never wait for a fetch.
+    //
+    class QueuesStore {
+    public:
+        QueuesStore();
+
+        QueuesStore(const QueuesStore &) = delete;
+        QueuesStore &operator=(const QueuesStore &) = delete;
+
+        // Returns the most recent snapshot or nullptr, if nothing has been published yet
+        std::shared_ptr<const QueuesSnapshot> load() const;
+
+        //
+        // Publishes queues fetched at the given time and returns the snapshot which is current afterwards.
+        // Queues revalidated by the server are published together with the queues they have been received as, and
+        // only the playing track advanced. As long as the received queues stay the same, so does the version.
+        // Queues fetched before the current snapshot are outdated and dropped, so a slow request never overwrites
+        // the result of a faster one.
+        //
+        std::shared_ptr<const QueuesSnapshot> publish(std::shared_ptr<const Queues> queues,
+                                                      const QueuesSnapshot::Clock::time_point fetchedAt,
+                                                      std::shared_ptr<const Queues> receivedQueues = nullptr);
+
+        // Versions of the snapshots published afterwards start over, so the store gets a new id as well
+        void clear();
+
+    private:
+        std::atomic<uint64_t> mStoreId;
+
+        // Only accessed through the atomic shared_ptr functions
+        std::shared_ptr<const QueuesSnapshot> mSnapshot;
+    };
+
+}  // namespace api::v1
+
+#endif
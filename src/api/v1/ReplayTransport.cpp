@@ -0,0 +1,140 @@
+/*****************************************************************************/
+/**
+ * @file    ReplayTransport.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a transport answering requests with the responses of a capture
+ */
+/*****************************************************************************/
+
+#include "ReplayTransport.h"
+
+#include <spdlog/spdlog.h>
+
+#include <thread>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+// Requests to the same endpoint differ in their query parameters (e.g. the search pattern) or their body
+static std::string makeRequestKey(const std::string &method, const std::string &path, const std::string &body) {
+    std::string key;
+    key.reserve(std::size(method) + std::size(path) + std::size(body) + 2);
+    key.append(method).append(1, ' ').append(path).append(1, '\n').append(body);
+    return key;
+}
+
+
+//
+// Constructors
+//
+
+CaptureReplay::CaptureReplay(std::vector<CapturedExchange> exchanges, const bool originalTiming)
+    : mExchanges(std::move(exchanges)), mOriginalTiming(originalTiming) {
+
+    for (size_t i {0}; i < std::size(mExchanges); ++i) {
+        const auto &exchange {mExchanges[i]};
+        mRequests[makeRequestKey(exchange.method, exchange.path, exchange.requestBody)].exchanges.push_back(i);
+    }
+}
+
+ReplayTransport::ReplayTransport(std::shared_ptr<CaptureReplay> replay) : mReplay(std::move(replay)) {}
+
+
+//
+// Replay
+//
+
+const CapturedExchange *CaptureReplay::next(const httplib::Request &request) {
+    const auto key {makeRequestKey(request.method, request.path, request.body)};
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    const auto it {mRequests.find(key)};
+    if (it == std::end(mRequests)) {
+        ++mStats.unmatched;
+        return nullptr;
+    }
+
+    auto &recorded {it->second};
+    const auto exchange {recorded.exchanges[recorded.nextExchange]};
+    recorded.nextExchange = (recorded.nextExchange + 1) % std::size(recorded.exchanges);
+
+    ++mStats.replayed;
+    return &mExchanges[exchange];
+}
+
+void CaptureReplay::rewind() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto &[key, recorded] : mRequests) {
+        recorded.nextExchange = 0;
+    }
+}
+
+bool CaptureReplay::isOriginalTiming() const noexcept { return mOriginalTiming; }
+
+
+ReplayStats CaptureReplay::getStats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mStats;
+}
+
+void CaptureReplay::resetStats() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = ReplayStats();
+}
+
+
+//
+// Exchanges
+//
+
+bool ReplayTransport::send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) {
+    timing = RequestTiming();
+
+    const auto exchange {mReplay->next(request)};
+    if (!exchange) {
+        spdlog::debug("ReplayTransport::send: no captured exchange for {} {}", request.method, request.path);
+        response        = httplib::Response();
+        response.status = 404;
+        return true;
+    }
+
+    // Without the original timing the exchange takes no time at all, only its size is reported
+    if (mReplay->isOriginalTiming()) {
+        timing = exchange->timing;
+        std::this_thread::sleep_for(timing.connect + timing.send + timing.wait + timing.receive);
+    } else {
+        timing.bytesSent     = exchange->timing.bytesSent;
+        timing.bytesReceived = exchange->timing.bytesReceived;
+    }
+
+    if (!exchange->responded) {
+        return false;
+    }
+
+    response         = httplib::Response();
+    response.status  = exchange->status;
+    response.headers = exchange->responseHeaders;
+    response.body    = exchange->responseBody;
+    return true;
+}
+
+bool ReplayTransport::isOpen() const { return false; }
+
+void ReplayTransport::close() {}
+
+void ReplayTransport::setKeepAlive(const bool) {}
+
+
+//
+// Statistics
+//
+
+size_t ReplayTransport::getConnectionsOpened() const noexcept { return 0; }
+
+void ReplayTransport::resetConnectionsOpened() noexcept {}
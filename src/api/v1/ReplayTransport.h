@@ -0,0 +1,93 @@
+/*****************************************************************************/
+/**
+ * @file    ReplayTransport.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a transport answering requests with the responses of a capture
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_REPLAY_TRANSPORT_H
+#define API_V1_REPLAY_TRANSPORT_H
+
+#include "api/v1/Capture.h"
+#include "api/v1/Transport.h"
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+namespace api::v1 {
+
+    struct ReplayStats {
+        size_t replayed {0};
+
+        // Requests without any recorded exchange, answered with status 404
+        size_t unmatched {0};
+    };
+
+
+    //
+    // The exchanges of a capture, shared by the transports of all connections of an Api. A request is answered by
+    // the next unused exchange with the same method, path and body. Exchanges of different requests may be used
+    // in any order, so the worker pool can replay concurrent requests. Once all exchanges of a request have been
+    // used, its exchanges are used again from the first one.
+    //
+    // With the original timing, every exchange takes as long as it took when it was captured. The time between
+    // two exchanges, e.g. the user typing the next command, is not replayed.
+    //
+    class CaptureReplay {
+    public:
+        CaptureReplay(std::vector<CapturedExchange> exchanges, const bool originalTiming);
+
+        // Returns nullptr if the request has not been captured
+        const CapturedExchange *next(const httplib::Request &request);
+
+        // Starts over with the first exchange of every request
+        void rewind();
+
+        bool isOriginalTiming() const noexcept;
+
+        ReplayStats getStats() const;
+        void resetStats();
+
+    private:
+        struct RecordedRequest {
+            std::vector<size_t> exchanges;
+            size_t nextExchange {0};
+        };
+
+        const std::vector<CapturedExchange> mExchanges;
+        const bool mOriginalTiming;
+
+        mutable std::mutex mMutex;
+        std::map<std::string, RecordedRequest> mRequests;
+        ReplayStats mStats;
+    };
+
+
+    class ReplayTransport : public Transport {
+    public:
+        explicit ReplayTransport(std::shared_ptr<CaptureReplay> replay);
+
+        // Exchanges which failed when captured fail again
+        bool send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) override;
+
+        // There is no channel to keep open, so failed exchanges are never retried
+        bool isOpen() const override;
+        void close() override;
+
+        void setKeepAlive(const bool keepAlive) override;
+
+        size_t getConnectionsOpened() const noexcept override;
+        void resetConnectionsOpened() noexcept override;
+
+    private:
+        std::shared_ptr<CaptureReplay> mReplay;
+    };
+
+}  // namespace api::v1
+
+#endif
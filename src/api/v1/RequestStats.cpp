@@ -0,0 +1,89 @@
+/*****************************************************************************/
+/**
+ * @file    RequestStats.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of per-endpoint latency histograms and byte counters for the REST API version 1
+ */
+/*****************************************************************************/
+
+#include "RequestStats.h"
+
+#include "exceptions/APIException.h"
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static uint64_t toMicroseconds(const std::chrono::microseconds duration) {
+    return uint64_t(std::max<std::chrono::microseconds::rep>(duration.count(), 0));
+}
+
+
+namespace api::v1 {
+
+    std::string to_string(const RequestPhase phase) {
+        switch (phase) {
+        case RequestPhase::CONNECT:
+            return "connect";
+        case RequestPhase::SEND:
+            return "send";
+        case RequestPhase::WAIT:
+            return "wait";
+        case RequestPhase::RECEIVE:
+            return "receive";
+        case RequestPhase::PARSE:
+            return "parse";
+
+        default:
+            throw APIException(APIExceptionCode::UNKNOWN_ENUM_VARIANT);
+        }
+    }
+
+}  // namespace api::v1
+
+
+//
+// Recording
+//
+
+void RequestStats::recordExchange(const std::string &endpoint, const RequestTiming &timing, const bool succeeded) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto &stats {mEndpoints[endpoint]};
+
+    ++stats.requests;
+    if (!succeeded) {
+        ++stats.failures;
+    }
+    stats.bytesSent += timing.bytesSent;
+    stats.bytesReceived += timing.bytesReceived;
+
+    stats.phases[size_t(RequestPhase::CONNECT)].record(toMicroseconds(timing.connect));
+    stats.phases[size_t(RequestPhase::SEND)].record(toMicroseconds(timing.send));
+    stats.phases[size_t(RequestPhase::WAIT)].record(toMicroseconds(timing.wait));
+    stats.phases[size_t(RequestPhase::RECEIVE)].record(toMicroseconds(timing.receive));
+    stats.total.record(toMicroseconds(timing.connect + timing.send + timing.wait + timing.receive));
+}
+
+void RequestStats::recordParse(const std::string &endpoint, const std::chrono::microseconds duration) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEndpoints[endpoint].phases[size_t(RequestPhase::PARSE)].record(toMicroseconds(duration));
+}
+
+
+//
+// Access
+//
+
+std::map<std::string, EndpointStats> RequestStats::getStats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEndpoints;
+}
+
+void RequestStats::reset() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEndpoints.clear();
+}
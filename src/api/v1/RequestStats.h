@@ -0,0 +1,63 @@
+/*****************************************************************************/
+/**
+ * @file    RequestStats.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of per-endpoint latency histograms and byte counters for the REST API version 1
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_REQUEST_STATS_H
+#define API_V1_REQUEST_STATS_H
+
+#include "api/v1/Connection.h"
+#include "utils/Histogram.h"
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+
+namespace api::v1 {
+
+    enum class RequestPhase { CONNECT, SEND, WAIT, RECEIVE, PARSE };
+
+    constexpr size_t REQUEST_PHASE_COUNT {5};
+
+    std::string to_string(const RequestPhase phase);
+
+
+    struct EndpointStats {
+        size_t requests {0};
+        size_t failures {0};
+        uint64_t bytesSent {0};
+        uint64_t bytesReceived {0};
+
+        // Durations in microseconds; total covers connect to receive, parse is recorded separately
+        std::array<sk::Histogram, REQUEST_PHASE_COUNT> phases;
+        sk::Histogram total;
+    };
+
+
+    class RequestStats {
+    public:
+        //
+        // Records an exchange with the server. Failures are exchanges without a response or with an error status.
+        //
+        void recordExchange(const std::string &endpoint, const RequestTiming &timing, const bool succeeded);
+
+        // Records the time spent turning a response body into API types
+        void recordParse(const std::string &endpoint, const std::chrono::microseconds duration);
+
+        std::map<std::string, EndpointStats> getStats() const;
+        void reset();
+
+    private:
+        mutable std::mutex mMutex;
+        std::map<std::string, EndpointStats> mEndpoints;
+    };
+
+}  // namespace api::v1
+
+#endif
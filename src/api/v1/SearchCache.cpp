@@ -0,0 +1,171 @@
+/*****************************************************************************/
+/**
+ * @file    SearchCache.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a bounded LRU cache for the search results of the REST API version 1
+ */
+/*****************************************************************************/
+
+#include "SearchCache.h"
+
+#include <cctype>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static std::string makeKey(const std::string &pattern, const unsigned int maxEntries) {
+    return std::to_string(maxEntries) + ':' + SearchCache::normalize(pattern);
+}
+
+// Approximation of the heap memory held by a cached result, including the bookkeeping of the entry
+static size_t estimateBytes(const std::string &key, const SearchCache::Tracks &tracks) {
+    size_t bytes {sizeof(SearchCache::Tracks) + 2 * key.capacity() + 64};
+    for (const auto &track : tracks) {
+        bytes += sizeof(BaseTrack) + track.trackId.capacity() + track.title.capacity() + track.iconUri.capacity()
+                 + (track.album ? track.album->capacity() : 0) + (track.artist ? track.artist->capacity() : 0);
+    }
+    return bytes;
+}
+
+
+//
+// Construction and configuration
+//
+
+SearchCache::SearchCache(const SearchCacheConfig &config) : mConfig(config) {}
+
+void SearchCache::setConfig(const SearchCacheConfig &config) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mConfig = config;
+    shrink();
+}
+
+SearchCacheConfig SearchCache::getConfig() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mConfig;
+}
+
+
+//
+// Lookup and insertion
+//
+
+std::shared_ptr<const SearchCache::Tracks> SearchCache::find(const std::string &pattern,
+                                                              const unsigned int maxEntries) {
+    const auto key {makeKey(pattern, maxEntries)};
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mConfig.capacity == 0) {
+        return nullptr;
+    }
+
+    const auto indexIt {mIndex.find(key)};
+    if (indexIt == mIndex.cend()) {
+        ++mStats.misses;
+        return nullptr;
+    }
+
+    const auto entryIt {indexIt->second};
+    if (Clock::now() >= entryIt->expiresAt) {
+        erase(entryIt);
+        ++mStats.expirations;
+        ++mStats.misses;
+        return nullptr;
+    }
+
+    // Move the entry to the front, it is the most recently used one now
+    mEntries.splice(std::begin(mEntries), mEntries, entryIt);
+
+    ++mStats.hits;
+    if (entryIt->tracks->empty()) {
+        ++mStats.negativeHits;
+    }
+    return entryIt->tracks;
+}
+
+void SearchCache::insert(const std::string &pattern, const unsigned int maxEntries, Tracks tracks) {
+    auto key {makeKey(pattern, maxEntries)};
+    const auto bytes {estimateBytes(key, tracks)};
+    auto sharedTracks {std::make_shared<const Tracks>(std::move(tracks))};
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mConfig.capacity == 0 || bytes > mConfig.maxBytes) {
+        return;
+    }
+
+    const auto indexIt {mIndex.find(key)};
+    if (indexIt != mIndex.cend()) {
+        erase(indexIt->second);
+    }
+
+    const auto ttl {sharedTracks->empty() ? mConfig.negativeTtl : mConfig.ttl};
+    mEntries.push_front(Entry {std::move(key), std::move(sharedTracks), bytes, Clock::now() + ttl});
+    mIndex.emplace(mEntries.front().key, std::begin(mEntries));
+    mBytes += bytes;
+
+    shrink();
+}
+
+
+//
+// Statistics and maintenance
+//
+
+SearchCacheStats SearchCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto stats {mStats};
+    stats.entries = std::size(mEntries);
+    stats.bytes   = mBytes;
+    return stats;
+}
+
+void SearchCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStats = SearchCacheStats();
+}
+
+void SearchCache::clear() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries.clear();
+    mIndex.clear();
+    mBytes = 0;
+}
+
+std::string SearchCache::normalize(const std::string &pattern) {
+    std::string normalized;
+    normalized.reserve(std::size(pattern));
+
+    bool pendingSpace {false};
+    for (const auto c : pattern) {
+        const auto uc {static_cast<unsigned char>(c)};
+        if (std::isspace(uc)) {
+            pendingSpace = !normalized.empty();
+            continue;
+        }
+
+        if (pendingSpace) {
+            normalized.push_back(' ');
+            pendingSpace = false;
+        }
+        normalized.push_back(static_cast<char>(std::tolower(uc)));
+    }
+    return normalized;
+}
+
+void SearchCache::erase(const std::list<Entry>::iterator entryIt) {
+    mBytes -= entryIt->bytes;
+    mIndex.erase(entryIt->key);
+    mEntries.erase(entryIt);
+}
+
+void SearchCache::shrink() {
+    while (!mEntries.empty() && (std::size(mEntries) > mConfig.capacity || mBytes > mConfig.maxBytes)) {
+        erase(std::prev(std::end(mEntries)));
+        ++mStats.evictions;
+    }
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************/
+/**
+ * @file    SearchCache.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a bounded LRU cache for the search results of the REST API version 1
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_SEARCH_CACHE_H
+#define API_V1_SEARCH_CACHE_H
+
+#include "api/v1/ApiTypes.h"
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace api::v1 {
+
+    struct SearchCacheConfig {
+        // A capacity of zero disables the cache
+        size_t capacity {128};
+        size_t maxBytes {size_t(4) << 20};
+        std::chrono::seconds ttl {300};
+
+        // Empty results are cached as well, but expire sooner as the library may still change
+        std::chrono::seconds negativeTtl {30};
+    };
+
+    struct SearchCacheStats {
+        size_t hits {0};
+        size_t negativeHits {0};
+        size_t misses {0};
+        size_t evictions {0};
+        size_t expirations {0};
+        size_t entries {0};
+        size_t bytes {0};
+    };
+
+
+    //
+    // Search results keyed by the normalized pattern and the maximum number of entries.
+    // Patterns are compared ignoring case and surrounding/repeated whitespace, just like the server does.
+    // The least recently used results are evicted as soon as either the capacity or the memory cap is exceeded.
+    //
+    class SearchCache {
+    public:
+        using Tracks = std::vector<BaseTrack>;
+
+        explicit SearchCache(const SearchCacheConfig &config = {});
+
+        // Returns the cached result or nullptr, if there is none or it expired
+        std::shared_ptr<const Tracks> find(const std::string &pattern, const unsigned int maxEntries);
+        void insert(const std::string &pattern, const unsigned int maxEntries, Tracks tracks);
+
+        void setConfig(const SearchCacheConfig &config);
+        SearchCacheConfig getConfig() const;
+
+        SearchCacheStats getStats() const;
+        void resetStats();
+        void clear();
+
+        static std::string normalize(const std::string &pattern);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Entry {
+            std::string key;
+            std::shared_ptr<const Tracks> tracks;
+            size_t bytes;
+            Clock::time_point expiresAt;
+        };
+
+        void erase(std::list<Entry>::iterator entryIt);
+        void shrink();
+
+        mutable std::mutex mMutex;
+        SearchCacheConfig mConfig;
+
+        // Most recently used entries first
+        std::list<Entry> mEntries;
+        std::unordered_map<std::string, std::list<Entry>::iterator> mIndex;
+        size_t mBytes {0};
+
+        SearchCacheStats mStats;
+    };
+
+}  // namespace api::v1
+
+#endif
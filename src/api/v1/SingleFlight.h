@@ -0,0 +1,91 @@
+/*****************************************************************************/
+/**
+ * @file    SingleFlight.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a request coalescing helper, which lets concurrent callers share one result
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_SINGLE_FLIGHT_H
+#define API_V1_SINGLE_FLIGHT_H
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+
+namespace api::v1 {
+
+    struct SingleFlightStats {
+        size_t executed {0};
+        size_t coalesced {0};
+    };
+
+
+    template<typename T>
+    class SingleFlight {
+    public:
+        //
+        // Runs the function unless a call with the same key is already in flight.
+        // In that case the caller waits for the running call and receives its result (or exception).
+        //
+        template<typename F>
+        T run(const std::string &key, F &&function) {
+            std::promise<T> promise;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+
+                const auto flightIt {mInFlight.find(key)};
+                if (flightIt != mInFlight.cend()) {
+                    auto sharedResult {flightIt->second};
+                    lock.unlock();
+
+                    ++mCoalesced;
+                    return sharedResult.get();
+                }
+
+                mInFlight.emplace(key, promise.get_future().share());
+            }
+
+            ++mExecuted;
+            try {
+                promise.set_value(function());
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+
+            std::shared_future<T> sharedResult;
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                const auto flightIt {mInFlight.find(key)};
+                sharedResult = std::move(flightIt->second);
+                mInFlight.erase(flightIt);
+            }
+            return sharedResult.get();
+        }
+
+        SingleFlightStats getStats() const noexcept {
+            SingleFlightStats stats;
+            stats.executed  = mExecuted;
+            stats.coalesced = mCoalesced;
+            return stats;
+        }
+
+        void resetStats() noexcept {
+            mExecuted  = 0;
+            mCoalesced = 0;
+        }
+
+    private:
+        std::mutex mMutex;
+        std::unordered_map<std::string, std::shared_future<T>> mInFlight;
+
+        std::atomic<size_t> mExecuted {0};
+        std::atomic<size_t> mCoalesced {0};
+    };
+
+}  // namespace api::v1
+
+#endif
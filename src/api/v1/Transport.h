@@ -0,0 +1,65 @@
+/*****************************************************************************/
+/**
+ * @file    Transport.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of the interface carrying requests of the REST API version 1 to a server
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_TRANSPORT_H
+#define API_V1_TRANSPORT_H
+
+#include <httplib/httplib.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+
+namespace api::v1 {
+
+    //
+    // Phases of a single exchange: connect is zero on a reused socket, wait lasts from the last byte
+    // sent to the first byte received.
+    //
+    struct RequestTiming {
+        std::chrono::microseconds connect {0};
+        std::chrono::microseconds send {0};
+        std::chrono::microseconds wait {0};
+        std::chrono::microseconds receive {0};
+        size_t bytesSent {0};
+        size_t bytesReceived {0};
+    };
+
+
+    //
+    // Exchanges requests and responses with a server. Every Connection owns a transport of its own and serializes
+    // the calls to it, so implementations do not need to be thread-safe.
+    //
+    class Transport {
+    public:
+        virtual ~Transport() = default;
+
+        //
+        // Performs a single exchange and returns false if no response has been received. The timing is reset and
+        // filled in by every call. A failed exchange leaves the transport closed.
+        // A kept open channel, which the other side closed while idle, should be detected before sending anything.
+        //
+        virtual bool send(const httplib::Request &request, httplib::Response &response, RequestTiming &timing) = 0;
+
+        // Whether the next exchange reuses a channel kept open by an earlier one
+        virtual bool isOpen() const = 0;
+        virtual void close() = 0;
+
+        virtual void setKeepAlive(const bool keepAlive) = 0;
+
+        virtual size_t getConnectionsOpened() const noexcept = 0;
+        virtual void resetConnectionsOpened() noexcept = 0;
+    };
+
+    // Creates the transports of every connection of an Api, e.g. one for each worker
+    using TransportFactory = std::function<std::unique_ptr<Transport>()>;
+
+}  // namespace api::v1
+
+#endif
@@ -0,0 +1,105 @@
+/*****************************************************************************/
+/**
+ * @file    WorkerPool.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a bounded pool of worker threads, each owning its own connection
+ */
+/*****************************************************************************/
+
+#include "WorkerPool.h"
+
+#include <spdlog/spdlog.h>
+
+
+using namespace api::v1;
+
+
+//
+// Constructors
+//
+
+WorkerPool::WorkerPool(const TransportFactory &transportFactory, const size_t workerCount, const bool keepAlive) {
+    spdlog::debug("WorkerPool::WorkerPool: {} workers", workerCount);
+
+    for (size_t i {0}; i < std::max<size_t>(workerCount, 1); ++i) {
+        mConnections.emplace_back(std::make_unique<Connection>(transportFactory(), keepAlive));
+    }
+    for (auto &connection : mConnections) {
+        mWorkers.emplace_back([this, worker = connection.get()] { workerLoop(*worker); });
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mTasksMutex);
+        mStopping = true;
+    }
+    mTasksCondition.notify_all();
+
+    for (auto &worker : mWorkers) {
+        worker.join();
+    }
+}
+
+
+//
+// Task handling
+//
+
+void WorkerPool::enqueue(Task &&task) {
+    {
+        std::lock_guard<std::mutex> lock(mTasksMutex);
+        mTasks.emplace_back(std::move(task));
+    }
+    mTasksCondition.notify_one();
+}
+
+void WorkerPool::workerLoop(Connection &connection) {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mTasksMutex);
+            mTasksCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+
+            // Drain the remaining tasks before stopping, so no future is left without a result
+            if (mTasks.empty()) {
+                return;
+            }
+
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+        }
+
+        task(connection);
+    }
+}
+
+
+//
+// Settings and statistics
+//
+
+size_t WorkerPool::getWorkerCount() const noexcept { return mWorkers.size(); }
+
+void WorkerPool::setKeepAlive(const bool keepAlive) {
+    for (auto &connection : mConnections) {
+        connection->setKeepAlive(keepAlive);
+    }
+}
+
+ConnectionStats WorkerPool::getConnectionStats() const noexcept {
+    ConnectionStats stats;
+    for (const auto &connection : mConnections) {
+        const auto connectionStats {connection->getStats()};
+        stats.connectionsOpened += connectionStats.connectionsOpened;
+        stats.requestsServed += connectionStats.requestsServed;
+        stats.reconnects += connectionStats.reconnects;
+    }
+    return stats;
+}
+
+void WorkerPool::resetConnectionStats() noexcept {
+    for (auto &connection : mConnections) {
+        connection->resetStats();
+    }
+}
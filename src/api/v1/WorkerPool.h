@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/**
+ * @file    WorkerPool.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a bounded pool of worker threads, each owning its own connection
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_WORKER_POOL_H
+#define API_V1_WORKER_POOL_H
+
+#include "api/v1/Connection.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace api::v1 {
+
+    class WorkerPool {
+    public:
+        using Task = std::function<void(Connection &)>;
+
+        WorkerPool(const TransportFactory &transportFactory, const size_t workerCount, const bool keepAlive = true);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool &) = delete;
+        WorkerPool &operator=(const WorkerPool &) = delete;
+
+        //
+        // Queues the task to be run on the connection of the next free worker.
+        // Exceptions thrown by the task are delivered through the returned future.
+        //
+        template<typename F>
+        auto submit(F &&task) -> std::future<std::invoke_result_t<F, Connection &>> {
+            using Result = std::invoke_result_t<F, Connection &>;
+
+            auto packagedTask {std::make_shared<std::packaged_task<Result(Connection &)>>(std::forward<F>(task))};
+            auto future {packagedTask->get_future()};
+            enqueue([packagedTask](Connection &connection) { (*packagedTask)(connection); });
+            return future;
+        }
+
+        size_t getWorkerCount() const noexcept;
+
+        void setKeepAlive(const bool keepAlive);
+        ConnectionStats getConnectionStats() const noexcept;
+        void resetConnectionStats() noexcept;
+
+    private:
+        void enqueue(Task &&task);
+        void workerLoop(Connection &connection);
+
+        std::vector<std::unique_ptr<Connection>> mConnections;
+        std::vector<std::thread> mWorkers;
+
+        std::deque<Task> mTasks;
+        std::mutex mTasksMutex;
+        std::condition_variable mTasksCondition;
+        bool mStopping {false};
+    };
+
+}  // namespace api::v1
+
+#endif
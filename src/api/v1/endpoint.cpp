@@ -0,0 +1,110 @@
+/*****************************************************************************/
+/**
+ * @file    endpoint.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of helper functions building request URLs for the REST API version 1
+ */
+/*****************************************************************************/
+
+#include "endpoint.h"
+
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+
+//
+// Helper functions
+//
+
+static bool isUnreserved(const unsigned char c) {
+    return std::isalnum(c) || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+static std::string encodeQueryValue(const std::string_view value) {
+    constexpr auto HEX_DIGITS {"0123456789ABCDEF"};
+
+    std::string encoded;
+    encoded.reserve(std::size(value));
+    for (const auto c : value) {
+        const auto byte {static_cast<unsigned char>(c)};
+        if (isUnreserved(byte)) {
+            encoded.push_back(c);
+        } else {
+            encoded.push_back('%');
+            encoded.push_back(HEX_DIGITS[byte >> 4]);
+            encoded.push_back(HEX_DIGITS[byte & 0x0F]);
+        }
+    }
+    return encoded;
+}
+
+static int getHexValue(const char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    } else if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    } else if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+
+namespace api::v1 {
+
+    std::string getRequestEndpoint(const std::string &endpoint) {
+        constexpr auto ENDPOINT_BASE_PATH {"/api/v1"};
+        return std::string(ENDPOINT_BASE_PATH) + "/" + endpoint;
+    }
+
+    std::string getRequestEndpoint(const std::string &endpoint, const std::map<std::string, std::string> &parameters) {
+        std::stringstream urlStream;
+        urlStream << getRequestEndpoint(endpoint);
+
+        bool firstParameter {true};
+
+        std::for_each(std::cbegin(parameters), std::cend(parameters), [&](const auto &kv) {
+            if (firstParameter) {
+                urlStream << "?";
+            } else {
+                urlStream << "&";
+            }
+            urlStream << kv.first << "=" << encodeQueryValue(kv.second);
+            firstParameter = false;
+        });
+
+        return urlStream.str();
+    }
+
+    std::string decodeQueryValue(const std::string_view value) {
+        std::string decoded;
+        decoded.reserve(std::size(value));
+        for (size_t i {0}; i < std::size(value); ++i) {
+            if (value[i] == '+') {
+                decoded.push_back(' ');
+                continue;
+            }
+
+            // Malformed escapes are kept as they are
+            if (value[i] == '%' && i + 2 < std::size(value) && getHexValue(value[i + 1]) >= 0
+                && getHexValue(value[i + 2]) >= 0) {
+                decoded.push_back(char(getHexValue(value[i + 1]) * 16 + getHexValue(value[i + 2])));
+                i += 2;
+                continue;
+            }
+            decoded.push_back(value[i]);
+        }
+        return decoded;
+    }
+
+    std::string getEndpointName(const std::string &url) {
+        const auto queryStart {url.find('?')};
+        const auto nameStart {url.rfind('/', queryStart)};
+
+        const auto begin {nameStart == std::string::npos ? 0 : nameStart + 1};
+        const auto end {queryStart == std::string::npos ? url.size() : queryStart};
+        return url.substr(begin, end - begin);
+    }
+
+}  // namespace api::v1
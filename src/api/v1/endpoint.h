@@ -0,0 +1,31 @@
+/*****************************************************************************/
+/**
+ * @file    endpoint.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of helper functions building request URLs for the REST API version 1
+ */
+/*****************************************************************************/
+
+#ifndef API_V1_ENDPOINT_H
+#define API_V1_ENDPOINT_H
+
+#include <map>
+#include <string>
+#include <string_view>
+
+
+namespace api::v1 {
+
+    std::string getRequestEndpoint(const std::string &endpoint);
+    // Parameter values are percent-encoded, so that patterns may contain characters such as '&', '#' or '+'
+    std::string getRequestEndpoint(const std::string &endpoint, const std::map<std::string, std::string> &parameters);
+
+    // Reverses the encoding of a query parameter, a '+' is decoded to a space like the server does
+    std::string decodeQueryValue(std::string_view value);
+
+    // Extracts the endpoint from a request URL built by getRequestEndpoint (e.g. "queryTracks")
+    std::string getEndpointName(const std::string &url);
+
+}  // namespace api::v1
+
+#endif
@@ -0,0 +1,535 @@
+/*****************************************************************************/
+/**
+ * @file    sax_deserializer.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of streaming deserializer functions, which fill the API types directly from
+ *          response bodies without building a JSON DOM first.
+ */
+/*****************************************************************************/
+
+#include "sax_deserializer.h"
+
+#include "exceptions/InvalidFormatException.h"
+
+#include <nlohmann/json.hpp>
+
+
+using json = nlohmann::json;
+
+
+namespace api::v1::sax {
+
+    namespace {
+
+        //
+        // Helper types
+        //
+
+        // Top level fields of the response bodies, holding the tracks
+        enum class Target { NONE, CURRENTLY_PLAYING, NORMAL_QUEUE, ADMIN_QUEUE, TRACKS };
+
+        // Fields of a track object, used as bit flags to check for missing fields
+        enum Field : unsigned int {
+            NO_FIELD     = 0,
+            TRACK_ID     = 1U << 0U,
+            TITLE        = 1U << 1U,
+            ALBUM        = 1U << 2U,
+            ARTIST       = 1U << 3U,
+            DURATION     = 1U << 4U,
+            ICON_URI     = 1U << 5U,
+            ADDED_BY     = 1U << 6U,
+            VOTES        = 1U << 7U,
+            CURRENT_VOTE = 1U << 8U,
+            PLAYING      = 1U << 9U,
+            PLAYING_FOR  = 1U << 10U,
+        };
+
+        constexpr unsigned int BASE_TRACK_FIELDS {TRACK_ID | TITLE | DURATION | ICON_URI};
+        constexpr unsigned int QUEUE_TRACK_FIELDS {BASE_TRACK_FIELDS | ADDED_BY};
+        constexpr unsigned int NORMAL_QUEUE_TRACK_FIELDS {QUEUE_TRACK_FIELDS | VOTES | CURRENT_VOTE};
+        constexpr unsigned int PLAYING_TRACK_FIELDS {QUEUE_TRACK_FIELDS | PLAYING | PLAYING_FOR};
+
+        enum class State { EXPECT_ROOT, ROOT_OBJECT, TRACK_LIST, TRACK, DONE };
+
+
+        Target getTarget(const std::string &key) {
+            if (key == "currently_playing") {
+                return Target::CURRENTLY_PLAYING;
+            } else if (key == "normal_queue") {
+                return Target::NORMAL_QUEUE;
+            } else if (key == "admin_queue") {
+                return Target::ADMIN_QUEUE;
+            } else if (key == "tracks") {
+                return Target::TRACKS;
+            }
+            return Target::NONE;
+        }
+
+        Field getField(const std::string &key) {
+            if (key == "track_id") {
+                return TRACK_ID;
+            } else if (key == "title") {
+                return TITLE;
+            } else if (key == "album") {
+                return ALBUM;
+            } else if (key == "artist") {
+                return ARTIST;
+            } else if (key == "duration") {
+                return DURATION;
+            } else if (key == "icon_uri") {
+                return ICON_URI;
+            } else if (key == "added_by") {
+                return ADDED_BY;
+            } else if (key == "votes") {
+                return VOTES;
+            } else if (key == "current_vote") {
+                return CURRENT_VOTE;
+            } else if (key == "playing") {
+                return PLAYING;
+            } else if (key == "playing_for") {
+                return PLAYING_FOR;
+            }
+            return NO_FIELD;
+        }
+
+
+        //
+        // SAX handler filling Queues or a list of tracks while the body is being parsed
+        //
+
+        class TrackSaxHandler : public nlohmann::json_sax<json> {
+        public:
+            TrackSaxHandler(const unsigned int acceptedTargets, const unsigned int requiredTargets)
+                : mAcceptedTargets(acceptedTargets), mRequiredTargets(requiredTargets) {}
+
+            bool null() override {
+                if (isSkipping()) {
+                    return true;
+                }
+
+                switch (mState) {
+                case State::ROOT_OBJECT:
+                    // 'currently_playing' is null if nothing is playing
+                    if (mTarget == Target::CURRENTLY_PLAYING) {
+                        markTargetSeen();
+                        return true;
+                    }
+                    return ignoreRootValue();
+
+                case State::TRACK:
+                    // Optional fields may be null as well
+                    if (mField == ALBUM || mField == ARTIST) {
+                        return true;
+                    }
+                    return ignoreTrackValue();
+
+                default:
+                    return fail("Unexpected null value");
+                }
+            }
+
+            bool boolean(bool val) override {
+                if (isSkipping()) {
+                    return true;
+                }
+                if (mState == State::TRACK && mField == PLAYING) {
+                    mTrack.playing = val;
+                    return setField();
+                }
+                return handleUnexpectedScalar();
+            }
+
+            bool number_integer(number_integer_t val) override { return number(val); }
+            bool number_unsigned(number_unsigned_t val) override { return number(static_cast<number_integer_t>(val)); }
+            bool number_float(number_float_t val, const string_t & /*s*/) override {
+                return number(static_cast<number_integer_t>(val));
+            }
+
+            bool string(string_t &val) override {
+                if (isSkipping()) {
+                    return true;
+                }
+                if (mState != State::TRACK) {
+                    return handleUnexpectedScalar();
+                }
+
+                switch (mField) {
+                case TRACK_ID:
+                    mTrack.trackId = std::move(val);
+                    break;
+                case TITLE:
+                    mTrack.title = std::move(val);
+                    break;
+                case ALBUM:
+                    mTrack.album = std::move(val);
+                    break;
+                case ARTIST:
+                    mTrack.artist = std::move(val);
+                    break;
+                case ICON_URI:
+                    mTrack.iconUri = std::move(val);
+                    break;
+                case ADDED_BY:
+                    mTrack.addedBy = std::move(val);
+                    break;
+                default:
+                    return ignoreTrackValue();
+                }
+                return setField();
+            }
+
+            bool binary(binary_t & /*val*/) override { return fail("Unexpected binary value"); }
+
+            bool start_object(std::size_t /*elements*/) override {
+                if (isSkipping()) {
+                    ++mSkipDepth;
+                    return true;
+                }
+
+                switch (mState) {
+                case State::EXPECT_ROOT:
+                    mState = State::ROOT_OBJECT;
+                    return true;
+
+                case State::ROOT_OBJECT:
+                    if (mTarget == Target::CURRENTLY_PLAYING) {
+                        markTargetSeen();
+                        beginTrack(State::ROOT_OBJECT);
+                        return true;
+                    }
+                    if (mTarget != Target::NONE) {
+                        return fail("Expected an array of tracks");
+                    }
+                    ++mSkipDepth;
+                    return true;
+
+                case State::TRACK_LIST:
+                    beginTrack(State::TRACK_LIST);
+                    return true;
+
+                case State::TRACK:
+                    if (mField != NO_FIELD) {
+                        return fail("Unexpected object as track field");
+                    }
+                    ++mSkipDepth;
+                    return true;
+
+                default:
+                    return fail("Unexpected object");
+                }
+            }
+
+            bool end_object() override {
+                if (isSkipping()) {
+                    --mSkipDepth;
+                    return true;
+                }
+
+                switch (mState) {
+                case State::ROOT_OBJECT:
+                    mState = State::DONE;
+                    return true;
+
+                case State::TRACK:
+                    return finishTrack();
+
+                default:
+                    return fail("Unexpected end of object");
+                }
+            }
+
+            bool start_array(std::size_t elements) override {
+                if (isSkipping()) {
+                    ++mSkipDepth;
+                    return true;
+                }
+
+                switch (mState) {
+                case State::ROOT_OBJECT:
+                    if (mTarget == Target::NONE) {
+                        ++mSkipDepth;
+                        return true;
+                    }
+                    if (mTarget == Target::CURRENTLY_PLAYING) {
+                        return fail("Expected a track object");
+                    }
+                    markTargetSeen();
+                    reserve(elements);
+                    mState = State::TRACK_LIST;
+                    return true;
+
+                case State::TRACK:
+                    if (mField != NO_FIELD) {
+                        return fail("Unexpected array as track field");
+                    }
+                    ++mSkipDepth;
+                    return true;
+
+                default:
+                    return fail("Unexpected array");
+                }
+            }
+
+            bool end_array() override {
+                if (isSkipping()) {
+                    --mSkipDepth;
+                    return true;
+                }
+                if (mState != State::TRACK_LIST) {
+                    return fail("Unexpected end of array");
+                }
+                mState = State::ROOT_OBJECT;
+                return true;
+            }
+
+            bool key(string_t &val) override {
+                if (isSkipping()) {
+                    return true;
+                }
+
+                if (mState == State::ROOT_OBJECT) {
+                    mTarget = getTarget(val);
+                    if ((targetBit(mTarget) & mAcceptedTargets) == 0) {
+                        mTarget = Target::NONE;
+                    }
+                } else if (mState == State::TRACK) {
+                    mField = getField(val);
+                }
+                return true;
+            }
+
+            bool parse_error(std::size_t /*position*/, const std::string & /*last_token*/,
+                             const nlohmann::detail::exception &ex) override {
+                return fail(ex.what());
+            }
+
+
+            bool isComplete() {
+                if (mState != State::DONE) {
+                    return fail("Incomplete JSON document");
+                }
+                if ((mSeenTargets & mRequiredTargets) != mRequiredTargets) {
+                    return fail("An expected field could not be found in JSON object.");
+                }
+                return true;
+            }
+
+            const std::string &getError() const noexcept { return mError; }
+
+            Queues &getQueues() noexcept { return mQueues; }
+            std::vector<BaseTrack> &getTracks() noexcept { return mTracks; }
+
+
+            static constexpr unsigned int targetBit(const Target target) {
+                return target == Target::NONE ? 0U : 1U << static_cast<unsigned int>(target);
+            }
+
+        private:
+            bool isSkipping() const noexcept { return mSkipDepth > 0; }
+
+            bool fail(const std::string &error) {
+                if (mError.empty()) {
+                    mError = error;
+                }
+                return false;
+            }
+
+            void markTargetSeen() noexcept { mSeenTargets |= targetBit(mTarget); }
+
+            bool ignoreRootValue() {
+                return mTarget == Target::NONE ? true : fail("Received JSON object is of wrong type");
+            }
+            bool ignoreTrackValue() {
+                return mField == NO_FIELD ? true : fail("Received JSON object is of wrong type");
+            }
+
+            bool handleUnexpectedScalar() {
+                switch (mState) {
+                case State::ROOT_OBJECT:
+                    return ignoreRootValue();
+                case State::TRACK:
+                    return ignoreTrackValue();
+                default:
+                    return fail("Unexpected value");
+                }
+            }
+
+            bool number(const number_integer_t val) {
+                if (isSkipping()) {
+                    return true;
+                }
+                if (mState != State::TRACK) {
+                    return handleUnexpectedScalar();
+                }
+
+                switch (mField) {
+                case DURATION:
+                    mTrack.duration = static_cast<int>(val);
+                    break;
+                case VOTES:
+                    mTrack.votes = static_cast<int>(val);
+                    break;
+                case CURRENT_VOTE:
+                    mTrack.currentVote = static_cast<int>(val);
+                    break;
+                case PLAYING_FOR:
+                    mTrack.playingFor = static_cast<int>(val);
+                    break;
+                default:
+                    return ignoreTrackValue();
+                }
+                return setField();
+            }
+
+            bool setField() noexcept {
+                mTrackFields |= mField;
+                return true;
+            }
+
+            void reserve(const std::size_t elements) {
+                // The element count is only known for binary formats
+                if (elements == std::size_t(-1)) {
+                    return;
+                }
+
+                switch (mTarget) {
+                case Target::NORMAL_QUEUE:
+                    mQueues.normalQueue.reserve(elements);
+                    break;
+                case Target::ADMIN_QUEUE:
+                    mQueues.adminQueue.reserve(elements);
+                    break;
+                case Target::TRACKS:
+                    mTracks.reserve(elements);
+                    break;
+                default:
+                    break;
+                }
+            }
+
+            void beginTrack(const State parent) {
+                mTrackParent = parent;
+                mState       = State::TRACK;
+                mField       = NO_FIELD;
+                mTrackFields = NO_FIELD;
+                mTrack       = {};
+            }
+
+            bool requireFields(const unsigned int fields) {
+                if ((mTrackFields & fields) != fields) {
+                    return fail("An expected field could not be found in JSON object.");
+                }
+                return true;
+            }
+
+            bool finishTrack() {
+                mState = mTrackParent;
+
+                switch (mTarget) {
+                case Target::CURRENTLY_PLAYING:
+                    // An empty object means nothing is playing
+                    if (mTrackFields == NO_FIELD) {
+                        return true;
+                    }
+                    if (!requireFields(PLAYING_TRACK_FIELDS)) {
+                        return false;
+                    }
+                    mQueues.currentlyPlaying = std::move(mTrack);
+                    return true;
+
+                case Target::NORMAL_QUEUE:
+                    if (!requireFields(NORMAL_QUEUE_TRACK_FIELDS)) {
+                        return false;
+                    }
+                    mQueues.normalQueue.emplace_back(std::move(static_cast<NormalQueueTrack &>(mTrack)));
+                    return true;
+
+                case Target::ADMIN_QUEUE:
+                    if (!requireFields(QUEUE_TRACK_FIELDS)) {
+                        return false;
+                    }
+                    mQueues.adminQueue.emplace_back(std::move(static_cast<QueueTrack &>(mTrack)));
+                    return true;
+
+                case Target::TRACKS:
+                    if (!requireFields(BASE_TRACK_FIELDS)) {
+                        return false;
+                    }
+                    mTracks.emplace_back(std::move(static_cast<BaseTrack &>(mTrack)));
+                    return true;
+
+                default:
+                    return fail("Unexpected track object");
+                }
+            }
+
+
+            // Superset of all track types, so that every field can be stored while parsing
+            struct AnyTrack : public NormalQueueTrack {
+                bool playing {false};
+                int playingFor {0};
+
+                operator PlayingTrack() && {
+                    PlayingTrack track;
+                    static_cast<QueueTrack &>(track) = std::move(static_cast<QueueTrack &>(*this));
+                    track.playing                    = playing;
+                    track.playingFor                 = playingFor;
+                    return track;
+                }
+            };
+
+            const unsigned int mAcceptedTargets;
+            const unsigned int mRequiredTargets;
+            unsigned int mSeenTargets {0};
+
+            State mState {State::EXPECT_ROOT};
+            State mTrackParent {State::ROOT_OBJECT};
+            Target mTarget {Target::NONE};
+            Field mField {NO_FIELD};
+            size_t mSkipDepth {0};
+
+            AnyTrack mTrack {};
+            unsigned int mTrackFields {NO_FIELD};
+
+            Queues mQueues;
+            std::vector<BaseTrack> mTracks;
+
+            std::string mError;
+        };
+
+
+        void parse(const std::string &body, TrackSaxHandler &handler) {
+            if (!json::sax_parse(body, &handler) || !handler.isComplete()) {
+                throw InvalidFormatException(handler.getError(), body);
+            }
+        }
+
+    }  // namespace
+
+
+    //
+    // Exported functions
+    //
+
+    template<>
+    Queues deserialize(const std::string &body) {
+        // 'currently_playing' is optional, both queues are required
+        constexpr auto REQUIRED_TARGETS {TrackSaxHandler::targetBit(Target::NORMAL_QUEUE)
+                                         | TrackSaxHandler::targetBit(Target::ADMIN_QUEUE)};
+        constexpr auto ACCEPTED_TARGETS {REQUIRED_TARGETS | TrackSaxHandler::targetBit(Target::CURRENTLY_PLAYING)};
+
+        TrackSaxHandler handler(ACCEPTED_TARGETS, REQUIRED_TARGETS);
+        parse(body, handler);
+        return std::move(handler.getQueues());
+    }
+
+    template<>
+    std::vector<BaseTrack> deserialize(const std::string &body) {
+        constexpr auto TARGETS {TrackSaxHandler::targetBit(Target::TRACKS)};
+
+        TrackSaxHandler handler(TARGETS, TARGETS);
+        parse(body, handler);
+        return std::move(handler.getTracks());
+    }
+
+}  // namespace api::v1::sax
@@ -0,0 +1,48 @@
+/*****************************************************************************/
+/**
+ * @file    sax_deserializer.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of streaming deserializer functions, which fill the API types directly from
+ *          response bodies without building a JSON DOM first.
+ */
+/*****************************************************************************/
+
+#ifndef SAX_DESERIALIZER_H
+#define SAX_DESERIALIZER_H
+
+#include "ApiTypes.h"
+
+#include <string>
+#include <vector>
+
+
+namespace api::v1 {
+
+    //
+    // Selects how response bodies get parsed. The DOM parser is kept around for comparison.
+    //
+    enum class ParserMode { DOM, SAX };
+
+
+    namespace sax {
+
+        //
+        // Parse complete response bodies in one pass.
+        // Supported types are Queues (body of getCurrentQueues) and std::vector<BaseTrack> (body of queryTracks).
+        // Throws an InvalidFormatException if the body is no valid JSON or misses required fields.
+        //
+
+        template<typename T>
+        T deserialize(const std::string &body);
+
+        template<>
+        Queues deserialize(const std::string &body);
+
+        template<>
+        std::vector<BaseTrack> deserialize(const std::string &body);
+
+    }  // namespace sax
+
+}  // namespace api::v1
+
+#endif
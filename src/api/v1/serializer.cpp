@@ -0,0 +1,58 @@
+/*****************************************************************************/
+/**
+ * @file    serializer.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of a generic serializer function for the types used by the REST API.
+ */
+/*****************************************************************************/
+
+
+#include "serializer.h"
+
+
+namespace api::v1::detail {
+
+    void serialize(json &j, const BaseTrack &track) {
+        j["track_id"] = track.trackId;
+        j["title"]    = track.title;
+        j["duration"] = track.duration;
+        j["icon_uri"] = track.iconUri;
+
+        if (track.album) {
+            j["album"] = track.album.value();
+        }
+        if (track.artist) {
+            j["artist"] = track.artist.value();
+        }
+    }
+
+    void serialize(json &j, const QueueTrack &track) {
+        serialize(j, static_cast<const BaseTrack &>(track));
+        j["added_by"] = track.addedBy;
+    }
+
+    void serialize(json &j, const NormalQueueTrack &track) {
+        serialize(j, static_cast<const QueueTrack &>(track));
+        j["votes"]        = track.votes;
+        j["current_vote"] = track.currentVote;
+    }
+
+    void serialize(json &j, const PlayingTrack &track) {
+        serialize(j, static_cast<const QueueTrack &>(track));
+        j["playing"]     = track.playing;
+        j["playing_for"] = track.playingFor;
+    }
+
+
+    void serialize(json &j, const Queues &queue) {
+        // The server sends an empty object if nothing is playing
+        j["currently_playing"] = json::object();
+        if (queue.currentlyPlaying) {
+            serialize(j["currently_playing"], queue.currentlyPlaying.value());
+        }
+
+        serialize(j["normal_queue"], queue.normalQueue);
+        serialize(j["admin_queue"], queue.adminQueue);
+    }
+
+}  // namespace api::v1::detail
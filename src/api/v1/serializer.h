@@ -0,0 +1,70 @@
+/*****************************************************************************/
+/**
+ * @file    serializer.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a generic serializer function for the types used by the REST API.
+ */
+/*****************************************************************************/
+
+#ifndef SERIALIZER_H
+#define SERIALIZER_H
+
+#include "ApiTypes.h"
+
+#include <nlohmann/json.hpp>
+
+
+using json = nlohmann::json;
+
+
+namespace api::v1 {
+
+    //
+    // Abstracted serialization functions, producing the JSON layout the server responds with
+    //
+
+    namespace detail {
+
+        //
+        // Overloads for all known API types
+        //
+
+        void serialize(json &, const BaseTrack &);
+        void serialize(json &, const QueueTrack &);
+        void serialize(json &, const NormalQueueTrack &);
+        void serialize(json &, const PlayingTrack &);
+
+        void serialize(json &, const Queues &);
+
+
+        //
+        // Specialization to serialize items of a container type
+        //
+
+        template<typename T>
+        void serialize(json &j, const std::vector<T> &vec) {
+            j = json::array();
+            for (const T &obj : vec) {
+                json jsonEntry;
+                serialize(jsonEntry, obj);
+                j.push_back(std::move(jsonEntry));
+            }
+        }
+
+    }  // namespace detail
+
+
+    //
+    // Function to be used by users
+    //
+
+    template<typename T>
+    json serialize(const T &t) {
+        json j;
+        detail::serialize(j, t);
+        return j;
+    }
+
+}  // namespace api::v1
+
+#endif
@@ -0,0 +1,304 @@
+/*****************************************************************************/
+/**
+ * @file    virtualjukebox.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of the C interface on top of REST Api version 1
+ */
+/*****************************************************************************/
+
+#include "virtualjukebox.h"
+
+#include "api/v1/Api.h"
+
+#include "exceptions/APIException.h"
+#include "exceptions/InvalidFormatException.h"
+#include "exceptions/NetworkException.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+using namespace api::v1;
+
+
+//
+// Opaque types, the strings of their tracks point into the C++ objects they own
+//
+
+struct vj_client {
+    vj_client(const char *address, const unsigned int port) : api(address, port) {}
+
+    Api api;
+};
+
+struct vj_track_list {
+    std::vector<BaseTrack> source;
+    std::vector<vj_track> tracks;
+};
+
+struct vj_queues {
+    // Shared with the snapshots of the Api, so that fetching them copies nothing but the views
+    std::shared_ptr<const Queues> source;
+    std::optional<vj_track> currentlyPlaying;
+    std::vector<vj_track> normalQueue;
+    std::vector<vj_track> adminQueue;
+};
+
+
+//
+// Helper functions
+//
+
+static thread_local std::string tLastError;
+
+static const char *toCString(const std::optional<std::string> &str) { return str ? str->c_str() : nullptr; }
+
+static vj_track makeTrack(const BaseTrack &track) {
+    vj_track result {};
+    result.track_id = track.trackId.c_str();
+    result.title    = track.title.c_str();
+    result.album    = toCString(track.album);
+    result.artist   = toCString(track.artist);
+    result.duration = track.duration;
+    result.icon_uri = track.iconUri.c_str();
+    return result;
+}
+
+static vj_track makeTrack(const QueueTrack &track) {
+    auto result {makeTrack(static_cast<const BaseTrack &>(track))};
+    result.added_by = track.addedBy.c_str();
+    return result;
+}
+
+static vj_track makeTrack(const NormalQueueTrack &track) {
+    auto result {makeTrack(static_cast<const QueueTrack &>(track))};
+    result.votes        = track.votes;
+    result.current_vote = track.currentVote;
+    return result;
+}
+
+static vj_track makeTrack(const PlayingTrack &track) {
+    auto result {makeTrack(static_cast<const QueueTrack &>(track))};
+    result.playing     = track.playing ? 1 : 0;
+    result.playing_for = track.playingFor;
+    return result;
+}
+
+static vj_status fail(const vj_status status, const std::string &message) {
+    tLastError = message;
+    return status;
+}
+
+//
+// Runs a call of the Api, translating its exceptions into status codes. Exceptions must never cross the C
+// interface.
+//
+template<typename Call>
+static vj_status translateExceptions(Call call) noexcept {
+    try {
+        call();
+        return VJ_OK;
+    } catch (const APIException &ex) {
+        return fail(VJ_ERROR_API, ex.what());
+    } catch (const NetworkException &ex) {
+        return fail(VJ_ERROR_NETWORK, ex.what());
+    } catch (const InvalidFormatException &ex) {
+        return fail(VJ_ERROR_FORMAT, ex.what());
+    } catch (const std::exception &ex) {
+        return fail(VJ_ERROR_UNKNOWN, ex.what());
+    } catch (...) {
+        return fail(VJ_ERROR_UNKNOWN, "Unknown exception");
+    }
+}
+
+static std::optional<QueueType> toQueueType(const vj_queue_type queueType) {
+    switch (queueType) {
+    case VJ_QUEUE_NORMAL:
+        return QueueType::NORMAL;
+    case VJ_QUEUE_ADMIN:
+        return QueueType::ADMIN;
+    }
+    return std::nullopt;
+}
+
+static std::optional<PlayerAction> toPlayerAction(const vj_player_action action) {
+    switch (action) {
+    case VJ_PLAYER_PLAY:
+        return PlayerAction::PLAY;
+    case VJ_PLAYER_PAUSE:
+        return PlayerAction::PAUSE;
+    case VJ_PLAYER_SKIP:
+        return PlayerAction::SKIP;
+    case VJ_PLAYER_VOLUME_UP:
+        return PlayerAction::VOLUME_UP;
+    case VJ_PLAYER_VOLUME_DOWN:
+        return PlayerAction::VOLUME_DOWN;
+    }
+    return std::nullopt;
+}
+
+static BaseTrack makeTrackReference(const char *trackId) {
+    BaseTrack track {};
+    track.trackId = trackId;
+    return track;
+}
+
+static std::optional<std::string> toOptionalString(const char *str) {
+    return str ? std::optional<std::string> {str} : std::nullopt;
+}
+
+
+//
+// General
+//
+
+unsigned int vj_abi_version(void) { return VJ_ABI_VERSION; }
+
+const char *vj_last_error(void) { return tLastError.c_str(); }
+
+
+//
+// Client and session
+//
+
+vj_client *vj_client_create(const char *address, const unsigned int port) {
+    if (!address || port == 0 || port > 65535) {
+        fail(VJ_ERROR_INVALID_ARGUMENT, "Invalid address or port");
+        return nullptr;
+    }
+
+    vj_client *client {nullptr};
+    const auto status {translateExceptions([&] { client = new vj_client(address, port); })};
+    return status == VJ_OK ? client : nullptr;
+}
+
+void vj_client_destroy(vj_client *client) { delete client; }
+
+vj_status vj_session_create(vj_client *client, const char *nickname) {
+    if (!client) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client given");
+    }
+    return translateExceptions([&] { client->api.generateSession(toOptionalString(nickname)); });
+}
+
+vj_status vj_admin_session_create(vj_client *client, const char *admin_password, const char *nickname) {
+    if (!client || !admin_password) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client or admin password given");
+    }
+    return translateExceptions(
+        [&] { client->api.generateAdminSession(admin_password, toOptionalString(nickname)); });
+}
+
+
+//
+// Queues
+//
+
+vj_status vj_queues_fetch(vj_client *client, vj_queues **queues) {
+    if (!client || !queues) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client or result given");
+    }
+
+    return translateExceptions([&] {
+        auto result {std::make_unique<vj_queues>()};
+        result->source = client->api.getRecentQueues()->queues;
+
+        const auto &source {*result->source};
+        if (source.currentlyPlaying) {
+            result->currentlyPlaying = makeTrack(source.currentlyPlaying.value());
+        }
+        result->normalQueue.reserve(std::size(source.normalQueue));
+        for (const auto &track : source.normalQueue) {
+            result->normalQueue.push_back(makeTrack(track));
+        }
+        result->adminQueue.reserve(std::size(source.adminQueue));
+        for (const auto &track : source.adminQueue) {
+            result->adminQueue.push_back(makeTrack(track));
+        }
+
+        *queues = result.release();
+    });
+}
+
+void vj_queues_free(vj_queues *queues) { delete queues; }
+
+const vj_track *vj_queues_currently_playing(const vj_queues *queues) {
+    return queues && queues->currentlyPlaying ? &queues->currentlyPlaying.value() : nullptr;
+}
+
+size_t vj_queues_size(const vj_queues *queues, const vj_queue_type queue_type) {
+    if (!queues) {
+        return 0;
+    }
+    return queue_type == VJ_QUEUE_ADMIN ? std::size(queues->adminQueue) : std::size(queues->normalQueue);
+}
+
+const vj_track *vj_queues_at(const vj_queues *queues, const vj_queue_type queue_type, const size_t index) {
+    if (index >= vj_queues_size(queues, queue_type)) {
+        return nullptr;
+    }
+    return queue_type == VJ_QUEUE_ADMIN ? &queues->adminQueue[index] : &queues->normalQueue[index];
+}
+
+
+//
+// Search
+//
+
+vj_status vj_tracks_search(vj_client *client, const char *pattern, const unsigned int max_entries,
+                           vj_track_list **tracks) {
+    if (!client || !pattern || !tracks) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client, pattern or result given");
+    }
+
+    return translateExceptions([&] {
+        auto result {std::make_unique<vj_track_list>()};
+        result->source = client->api.queryTracks(pattern, max_entries);
+
+        result->tracks.reserve(std::size(result->source));
+        for (const auto &track : result->source) {
+            result->tracks.push_back(makeTrack(track));
+        }
+
+        *tracks = result.release();
+    });
+}
+
+void vj_track_list_free(vj_track_list *tracks) { delete tracks; }
+
+size_t vj_track_list_size(const vj_track_list *tracks) { return tracks ? std::size(tracks->tracks) : 0; }
+
+const vj_track *vj_track_list_at(const vj_track_list *tracks, const size_t index) {
+    return index < vj_track_list_size(tracks) ? &tracks->tracks[index] : nullptr;
+}
+
+
+//
+// Actions
+//
+
+vj_status vj_track_add(vj_client *client, const char *track_id, const vj_queue_type queue_type) {
+    const auto optQueueType {toQueueType(queue_type)};
+    if (!client || !track_id || !optQueueType) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client, track or valid queue type given");
+    }
+    return translateExceptions([&] { client->api.addTrack(makeTrackReference(track_id), optQueueType.value()); });
+}
+
+vj_status vj_track_vote(vj_client *client, const char *track_id, const vj_vote vote) {
+    if (!client || !track_id || (vote != VJ_VOTE_REVOKE && vote != VJ_VOTE_UP)) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client, track or valid vote given");
+    }
+    const auto apiVote {vote == VJ_VOTE_UP ? Vote::UP_VOTE : Vote::DOWN_VOTE};
+    return translateExceptions([&] { client->api.voteTrack(makeTrackReference(track_id), apiVote); });
+}
+
+vj_status vj_player_control(vj_client *client, const vj_player_action action) {
+    const auto optAction {toPlayerAction(action)};
+    if (!client || !optAction) {
+        return fail(VJ_ERROR_INVALID_ARGUMENT, "No client or valid action given");
+    }
+    return translateExceptions([&] { client->api.controlPlayer(optAction.value()); });
+}
@@ -0,0 +1,134 @@
+/*****************************************************************************/
+/**
+ * @file    virtualjukebox.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   C interface of the VirtualJukebox client library
+ */
+/*****************************************************************************/
+
+#ifndef VIRTUALJUKEBOX_H
+#define VIRTUALJUKEBOX_H
+
+#include <stddef.h>
+
+#if defined(__GNUC__)
+#define VJ_API __attribute__((visibility("default")))
+#else
+#define VJ_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Incremented whenever a function or type changes incompatibly. Types are only ever handed out by pointer and owned
+ * by the library, so appending members to vj_track or adding functions keeps the version.
+ */
+#define VJ_ABI_VERSION 1
+
+
+/*
+ * Every function returning a vj_status stores a description of a failure, which can be read by vj_last_error on the
+ * same thread until the next failure.
+ */
+typedef enum vj_status {
+    VJ_OK = 0,
+    VJ_ERROR_INVALID_ARGUMENT = 1,
+    VJ_ERROR_API              = 2, /* e.g. no session has been created yet or admin rights are missing */
+    VJ_ERROR_NETWORK          = 3, /* the server could not be reached or answered with an error */
+    VJ_ERROR_FORMAT           = 4, /* the response of the server could not be parsed */
+    VJ_ERROR_UNKNOWN          = 5
+} vj_status;
+
+typedef enum vj_queue_type { VJ_QUEUE_NORMAL = 0, VJ_QUEUE_ADMIN = 1 } vj_queue_type;
+
+typedef enum vj_vote { VJ_VOTE_REVOKE = 0, VJ_VOTE_UP = 1 } vj_vote;
+
+typedef enum vj_player_action {
+    VJ_PLAYER_PLAY        = 0,
+    VJ_PLAYER_PAUSE       = 1,
+    VJ_PLAYER_SKIP        = 2,
+    VJ_PLAYER_VOLUME_UP   = 3,
+    VJ_PLAYER_VOLUME_DOWN = 4
+} vj_player_action;
+
+/*
+ * A track as found by a search or as part of the queues. The strings are valid as long as the list or queues the
+ * track belongs to. Optional strings are NULL if the server did not provide them.
+ */
+typedef struct vj_track {
+    const char *track_id;
+    const char *title;
+    const char *album;    /* optional */
+    const char *artist;   /* optional */
+    int duration;         /* in milliseconds */
+    const char *icon_uri;
+    const char *added_by; /* NULL for search results */
+    int votes;            /* only tracks of the normal queue have votes, 0 otherwise */
+    int current_vote;     /* vote of the own session */
+    int playing;          /* only set for the currently playing track */
+    int playing_for;      /* in milliseconds, only set for the currently playing track */
+} vj_track;
+
+/* Holds a session and the connections to one server, calls on the same client must not overlap */
+typedef struct vj_client vj_client;
+typedef struct vj_track_list vj_track_list;
+typedef struct vj_queues vj_queues;
+
+
+VJ_API unsigned int vj_abi_version(void);
+VJ_API const char *vj_last_error(void);
+
+
+/*
+ * Client and session
+ */
+
+/* Returns NULL if the arguments are invalid, no connection is opened before the first request */
+VJ_API vj_client *vj_client_create(const char *address, unsigned int port);
+VJ_API void vj_client_destroy(vj_client *client);
+
+/* The nickname is optional and may be NULL */
+VJ_API vj_status vj_session_create(vj_client *client, const char *nickname);
+VJ_API vj_status vj_admin_session_create(vj_client *client, const char *admin_password, const char *nickname);
+
+
+/*
+ * Queues
+ */
+
+VJ_API vj_status vj_queues_fetch(vj_client *client, vj_queues **queues);
+VJ_API void vj_queues_free(vj_queues *queues);
+
+/* NULL if nothing is playing */
+VJ_API const vj_track *vj_queues_currently_playing(const vj_queues *queues);
+VJ_API size_t vj_queues_size(const vj_queues *queues, vj_queue_type queue_type);
+VJ_API const vj_track *vj_queues_at(const vj_queues *queues, vj_queue_type queue_type, size_t index);
+
+
+/*
+ * Search
+ */
+
+VJ_API vj_status vj_tracks_search(vj_client *client, const char *pattern, unsigned int max_entries,
+                                  vj_track_list **tracks);
+VJ_API void vj_track_list_free(vj_track_list *tracks);
+
+VJ_API size_t vj_track_list_size(const vj_track_list *tracks);
+VJ_API const vj_track *vj_track_list_at(const vj_track_list *tracks, size_t index);
+
+
+/*
+ * Actions
+ */
+
+VJ_API vj_status vj_track_add(vj_client *client, const char *track_id, vj_queue_type queue_type);
+VJ_API vj_status vj_track_vote(vj_client *client, const char *track_id, vj_vote vote);
+VJ_API vj_status vj_player_control(vj_client *client, vj_player_action action);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
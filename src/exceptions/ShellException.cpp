@@ -23,6 +23,9 @@ static std::string mapExceptionCodeToString(ShellExceptionCode code) {
     case ShellExceptionCode::INVALID_ARGUMENT_VALUE:
         return "An argument of the given command has an invalid value.";
 
+    case ShellExceptionCode::UNTERMINATED_QUOTE:
+        return "The input contains a quote which is never closed.";
+
     default:
         return "Unknown error (" + std::to_string(static_cast<int>(code)) + ")";
     }
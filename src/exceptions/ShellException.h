@@ -10,7 +10,8 @@ enum class ShellExceptionCode : int {
     COMMAND_ALREADY_EXISTS,
     INVALID_ARGUMENT_NUMBER,
     INVALID_ARGUMENT_FORMAT,
-    INVALID_ARGUMENT_VALUE
+    INVALID_ARGUMENT_VALUE,
+    UNTERMINATED_QUOTE
     // TODO: to be extended
 };
 
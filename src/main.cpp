@@ -1,22 +1,170 @@
 
 
 #include "api/v1/Api.h"
+#include "api/v1/Capture.h"
+#include "api/v1/ReplayTransport.h"
+#include "shell/Daemon.h"
 #include "shell/Shell.h"
 #include "shell/commands/v1/ApiCommands.h"
 
 #include "Exception.h"
+#include "utils/Tracer.h"
+#include "utils/utils.h"
 
+#include <docopt/docopt.h>
 #include <spdlog/spdlog.h>
 
 #include <cassert>
+#include <fstream>
 #include <iostream>
 
 #include <sstream>
 
 
-int main() {
+static constexpr auto USAGE {
+    R"(VirtualJukebox CLI client.
+
+Usage:
+  virtualjukebox-cli [--trace=<file>] [--record=<file> | --replay=<file> [--timed]]
+  virtualjukebox-cli --batch [--jobs=<count>] [--trace=<file>] [--record=<file> | --replay=<file> [--timed]]
+                     [<script>]
+  virtualjukebox-cli --daemon [--socket=<path>] [--jobs=<count>] [--trace=<file>] [--record=<file>]
+  virtualjukebox-cli --client [--socket=<path>] [<command>...]
+  virtualjukebox-cli (-h | --help)
+
+Options:
+  -h --help       Show this screen.
+  --trace=<file>  Record commands, requests, parsing, prompts and rendering as Chrome trace events.
+                  The file is written on exit and can be opened in chrome://tracing or ui.perfetto.dev.
+  --record=<file> Capture every request and response, including their timing, to the file.
+                  Only the user may read it, as it holds passwords and session ids.
+  --replay=<file> Answer all requests with the responses captured by --record instead of contacting a server.
+                  Running the same commands again replays the session without any network involved.
+  --timed         Let every replayed exchange take as long as it took when it was captured.
+  --batch         Run all commands of the script (or of stdin, if no script is given) without prompting.
+                  Lines starting with '>' answer the prompts of the preceding command.
+                  Exits with status 2 if any command failed.
+  --jobs=<count>  Maximum number of read-only commands (e.g. print) executed at once in batch mode. [default: 4]
+  --daemon        Keep the session, connections and caches alive and run the scripts sent by clients in batch mode.
+                  Stops on SIGINT or SIGTERM.
+  --client        Send a command (or the script read from stdin, if no command is given) to a running daemon and
+                  print its output. Exits with the status batch mode would exit with.
+  --socket=<path> Unix domain socket the daemon listens on. Defaults to virtualjukebox.sock in $XDG_RUNTIME_DIR,
+                  or to /tmp/virtualjukebox-<uid>.sock without it.
+)"};
+
+
+static std::optional<unsigned int> getJobs(const std::map<std::string, docopt::value> &args) {
+    const auto optJobs {sk::to_number<unsigned int>(args.at("--jobs").asString())};
+    if (!optJobs || optJobs.value() == 0) {
+        std::cerr << "Invalid number of jobs '" << args.at("--jobs").asString() << "'" << std::endl;
+        return std::nullopt;
+    }
+    return optJobs;
+}
+
+static std::string getSocketPath(const std::map<std::string, docopt::value> &args) {
+    const auto &socketPath {args.at("--socket")};
+    return socketPath ? socketPath.asString() : getDefaultSocketPath();
+}
+
+static int runBatch(Shell &shell, const std::map<std::string, docopt::value> &args) {
+    const auto optJobs {getJobs(args)};
+    if (!optJobs) {
+        return 1;
+    }
+
+    BatchResult result;
+    const auto &scriptPath {args.at("<script>")};
+    if (scriptPath) {
+        std::ifstream script(scriptPath.asString());
+        if (!script) {
+            std::cerr << "Failed to open script '" << scriptPath.asString() << "'" << std::endl;
+            return 1;
+        }
+        result = shell.handleBatch(script, std::cout, optJobs.value());
+    } else {
+        result = shell.handleBatch(std::cin, std::cout, optJobs.value());
+    }
+
+    if (result.failedLines.empty()) {
+        return 0;
+    }
+
+    std::cerr << fmt::format("{} of {} commands failed (lines {})", std::size(result.failedLines),
+                             result.executedCommands, fmt::join(result.failedLines, ", "))
+              << std::endl;
+    return 2;
+}
+
+
+static bool startRecording(const std::string &path) {
+    auto capture {api::v1::CaptureWriter::open(path)};
+    if (!capture) {
+        std::cerr << "Failed to open capture file '" << path << "'" << std::endl;
+        return false;
+    }
+
+    api::v1::Api::setInstanceCapture(std::move(capture));
+    return true;
+}
+
+// Every Api created by a login answers from the capture
+static std::shared_ptr<api::v1::CaptureReplay> startReplay(const std::string &path, const bool timed) {
+    auto exchanges {api::v1::readCapture(path)};
+    if (!exchanges) {
+        std::cerr << "Failed to read capture file '" << path << "'" << std::endl;
+        return nullptr;
+    }
+
+    auto replay {std::make_shared<api::v1::CaptureReplay>(std::move(exchanges.value()), timed)};
+    api::v1::Api::setInstanceTransportFactory([replay] { return std::make_unique<api::v1::ReplayTransport>(replay); });
+    return replay;
+}
+
+
+// The client does not need a shell of its own, the one of the daemon executes the commands
+static int sendToDaemon(const std::map<std::string, docopt::value> &args) {
+    const auto &command {args.at("<command>").asStringList()};
+    if (!command.empty()) {
+        return runClient(getSocketPath(args), joinCommandLine(command) + '\n', std::cout);
+    }
+
+    std::ostringstream script;
+    script << std::cin.rdbuf();
+    return runClient(getSocketPath(args), script.str(), std::cout);
+}
+
+
+int main(int argc, const char **argv) {
+    const auto args {docopt::docopt(USAGE, {std::next(argv), std::next(argv, argc)}, true)};
+
     spdlog::set_level(spdlog::level::off);
 
+    if (args.at("--client").asBool()) {
+        return sendToDaemon(args);
+    }
+
+    const auto &recordPath {args.at("--record")};
+    if (recordPath && !startRecording(recordPath.asString())) {
+        return 1;
+    }
+
+    std::shared_ptr<api::v1::CaptureReplay> replay;
+    const auto &replayPath {args.at("--replay")};
+    if (replayPath) {
+        replay = startReplay(replayPath.asString(), args.at("--timed").asBool());
+        if (!replay) {
+            return 1;
+        }
+    }
+
+    const auto &tracePath {args.at("--trace")};
+    if (tracePath && !sk::Tracer::getInstance().start(tracePath.asString())) {
+        std::cerr << "Failed to open trace file '" << tracePath.asString() << "'" << std::endl;
+        return 1;
+    }
+
     Shell shell("VirtualJukebox> ");
     shell.addCommand("login", std::make_unique<commands::v1::Login>());
     shell.addCommand("print", std::make_unique<commands::v1::PrintQueues>());
@@ -26,7 +174,28 @@ int main() {
     shell.addCommand("skip", std::make_unique<commands::v1::Skip>());
     shell.addCommand("volume", std::make_unique<commands::v1::Volume>());
     shell.addCommand("vote", std::make_unique<commands::v1::Vote>());
-    shell.handleInputs(std::cin, std::cout);
+    shell.addCommand("connection", std::make_unique<commands::v1::ConnectionInfo>());
+    shell.addCommand("stats", std::make_unique<commands::v1::RequestStatistics>());
+    shell.addCommand("cache", std::make_unique<commands::v1::SearchCacheInfo>());
+    shell.addCommand("autorefresh", std::make_unique<commands::v1::AutoRefresh>());
+    shell.addCommand("import", std::make_unique<commands::v1::ImportPlaylist>());
+    shell.addCommand("organize", std::make_unique<commands::v1::OrganizeQueues>());
+
+    int status {0};
+    if (args.at("--batch").asBool()) {
+        status = runBatch(shell, args);
+    } else if (args.at("--daemon").asBool()) {
+        const auto optJobs {getJobs(args)};
+        status = optJobs ? runDaemon(shell, getSocketPath(args), optJobs.value()) : 1;
+    } else {
+        shell.handleInputs(std::cin, std::cout);
+    }
+
+    sk::Tracer::getInstance().stop();
 
-    return 0;
+    // Requests the capture has no response for are answered with 404, so the commands diverged from the session
+    if (replay && replay->getStats().unmatched > 0) {
+        std::cerr << fmt::format("{} requests have not been captured", replay->getStats().unmatched) << std::endl;
+    }
+    return status;
 }
@@ -0,0 +1,392 @@
+#include "Daemon.h"
+#include "Shell.h"
+
+#include "utils/Tracer.h"
+
+#include <fmt/format.h>
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+
+//
+// Helper types
+//
+
+namespace {
+
+    // Marks the end of the output, it is followed by the exit status
+    constexpr char END_OF_OUTPUT {'\0'};
+
+    // Scripts are sent by scripts or users, anything larger is most likely no script at all
+    constexpr size_t MAX_SCRIPT_SIZE {1024 * 1024};
+
+    // A client which neither sends nor closes its script would block every other client
+    constexpr int RECEIVE_TIMEOUT_MS {5000};
+
+    // Accepting fails as long as the process is out of descriptors, there is no point in trying more often
+    constexpr std::chrono::seconds ACCEPT_RETRY_DELAY {1};
+
+    volatile std::sig_atomic_t gStopRequested {0};
+
+    extern "C" void requestStop(int) { gStopRequested = 1; }
+
+    // Closes the descriptor once it goes out of scope
+    class FileDescriptor {
+    public:
+        explicit FileDescriptor(const int fd) : mFd(fd) {}
+        ~FileDescriptor() {
+            if (mFd >= 0) {
+                ::close(mFd);
+            }
+        }
+
+        FileDescriptor(const FileDescriptor &) = delete;
+        FileDescriptor &operator=(const FileDescriptor &) = delete;
+
+        int get() const noexcept { return mFd; }
+        bool isValid() const noexcept { return mFd >= 0; }
+
+    private:
+        int mFd;
+    };
+
+    //
+    // Writes everything put into the stream to a socket. Once the client went away, the remaining output is dropped,
+    // so the script still runs to its end.
+    //
+    class SocketBuffer : public std::streambuf {
+    public:
+        explicit SocketBuffer(const int fd) : mFd(fd) { setp(std::begin(mBuffer), std::end(mBuffer)); }
+
+        bool isConnected() const noexcept { return mConnected; }
+
+    protected:
+        int_type overflow(const int_type c) override {
+            if (!flushBuffer()) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        int sync() override { return flushBuffer() ? 0 : -1; }
+
+    private:
+        bool flushBuffer() {
+            const char *data {pbase()};
+            auto remaining {size_t(pptr() - pbase())};
+            while (mConnected && remaining > 0) {
+                const auto sent {::send(mFd, data, remaining, MSG_NOSIGNAL)};
+                if (sent < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (sent <= 0) {
+                    mConnected = false;
+                    break;
+                }
+                data += sent;
+                remaining -= size_t(sent);
+            }
+            setp(std::begin(mBuffer), std::end(mBuffer));
+            return mConnected;
+        }
+
+        int mFd;
+        bool mConnected {true};
+        std::array<char, 4096> mBuffer {};
+    };
+
+}  // namespace
+
+
+//
+// Helper functions
+//
+
+static std::optional<sockaddr_un> makeAddress(const std::string &socketPath) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    // The path has to fit including its terminating NUL
+    if (socketPath.empty() || std::size(socketPath) >= sizeof(address.sun_path)) {
+        return std::nullopt;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), std::size(socketPath) + 1);
+    return address;
+}
+
+static bool connectTo(const int fd, const sockaddr_un &address) {
+    return ::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+}
+
+static bool sendAll(const int fd, std::string_view data) {
+    while (!data.empty()) {
+        const auto sent {::send(fd, std::data(data), std::size(data), MSG_NOSIGNAL)};
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            return false;
+        }
+        data.remove_prefix(size_t(sent));
+    }
+    return true;
+}
+
+// Reads until the client shuts down its writing side, fails on errors, timeouts and oversized scripts
+static std::optional<std::string> receiveScript(const int fd) {
+    std::string script;
+    std::array<char, 4096> buffer {};
+
+    while (true) {
+        pollfd pollFd {fd, POLLIN, 0};
+        const auto ready {::poll(&pollFd, 1, RECEIVE_TIMEOUT_MS)};
+        if (ready < 0 && errno == EINTR && !gStopRequested) {
+            continue;
+        }
+        if (ready <= 0) {
+            return std::nullopt;
+        }
+
+        const auto received {::recv(fd, std::data(buffer), std::size(buffer), 0)};
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received < 0) {
+            return std::nullopt;
+        }
+        if (received == 0) {
+            return script;
+        }
+
+        script.append(std::data(buffer), size_t(received));
+        if (std::size(script) > MAX_SCRIPT_SIZE) {
+            return std::nullopt;
+        }
+    }
+}
+
+static void serveClient(Shell &shell, const int fd, const size_t jobs) {
+    sk::TraceSpan span("daemon", "serveClient");
+
+    const auto optScript {receiveScript(fd)};
+    if (!optScript) {
+        std::cerr << "Dropped a client which did not send a valid script" << std::endl;
+        return;
+    }
+
+    std::istringstream script(optScript.value());
+    SocketBuffer buffer(fd);
+    std::ostream out(&buffer);
+
+    const auto result {shell.handleBatch(script, out, jobs)};
+    out << END_OF_OUTPUT << (result.failedLines.empty() ? '0' : '2') << std::flush;
+}
+
+static bool installSignalHandlers() {
+    // Without SA_RESTART, a blocking accept returns once a signal arrived
+    struct sigaction action {};
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    return ::sigaction(SIGINT, &action, nullptr) == 0 && ::sigaction(SIGTERM, &action, nullptr) == 0;
+}
+
+
+//
+// Daemon
+//
+
+std::string getDefaultSocketPath() {
+    if (const auto *runtimeDir {std::getenv("XDG_RUNTIME_DIR")}; runtimeDir && *runtimeDir != '\0') {
+        return fmt::format("{}/virtualjukebox.sock", runtimeDir);
+    }
+    return fmt::format("/tmp/virtualjukebox-{}.sock", ::getuid());
+}
+
+int runDaemon(Shell &shell, const std::string &socketPath, const size_t jobs) {
+    const auto optAddress {makeAddress(socketPath)};
+    if (!optAddress) {
+        std::cerr << "Invalid socket path '" << socketPath << "'" << std::endl;
+        return 1;
+    }
+    const auto &address {optAddress.value()};
+
+    // A socket file nobody listens on is left over from a daemon which did not shut down cleanly
+    {
+        FileDescriptor probe(::socket(AF_UNIX, SOCK_STREAM, 0));
+        if (probe.isValid() && connectTo(probe.get(), address)) {
+            std::cerr << "A daemon is already listening on '" << socketPath << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    // Only a socket is removed, any other file at that path is most likely a mistyped option
+    struct stat fileStatus {};
+    if (::lstat(socketPath.c_str(), &fileStatus) == 0) {
+        if (!S_ISSOCK(fileStatus.st_mode)) {
+            std::cerr << "'" << socketPath << "' exists and is not a socket" << std::endl;
+            return 1;
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+    FileDescriptor server(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!server.isValid()) {
+        std::cerr << "Failed to create a socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+
+    // The daemon acts with the session of its user, nobody else may send it commands. The socket file is created
+    // with these permissions right away, so there is no moment in which others could connect.
+    const auto previousMask {::umask(S_IXUSR | S_IRWXG | S_IRWXO)};
+    const auto bound {::bind(server.get(), reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0};
+    const auto bindError {errno};
+    ::umask(previousMask);
+
+    if (!bound) {
+        std::cerr << "Failed to bind '" << socketPath << "': " << std::strerror(bindError) << std::endl;
+        return 1;
+    }
+    if (::chmod(socketPath.c_str(), S_IRUSR | S_IWUSR) != 0) {
+        std::cerr << "Failed to restrict the permissions of '" << socketPath << "': " << std::strerror(errno)
+                  << std::endl;
+        ::unlink(socketPath.c_str());
+        return 1;
+    }
+
+    if (::listen(server.get(), SOMAXCONN) != 0 || !installSignalHandlers()) {
+        std::cerr << "Failed to listen on '" << socketPath << "': " << std::strerror(errno) << std::endl;
+        ::unlink(socketPath.c_str());
+        return 1;
+    }
+
+    std::cout << "Listening on '" << socketPath << "'" << std::endl;
+
+    int status {0};
+    while (!gStopRequested) {
+        FileDescriptor client(::accept(server.get(), nullptr, nullptr));
+        if (!client.isValid()) {
+            const auto error {errno};
+
+            // Interrupted by a signal or the client gave up before it got accepted
+            if (error == EINTR || error == ECONNABORTED) {
+                continue;
+            }
+
+            // Out of descriptors or memory, which may be released again; retrying right away would only spin
+            if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+                std::cerr << "Failed to accept a client, retrying in a second: " << std::strerror(error) << std::endl;
+                std::this_thread::sleep_for(ACCEPT_RETRY_DELAY);
+                continue;
+            }
+
+            std::cerr << "Failed to accept a client: " << std::strerror(error) << std::endl;
+            status = 1;
+            break;
+        }
+        serveClient(shell, client.get(), jobs);
+    }
+
+    ::unlink(socketPath.c_str());
+    return status;
+}
+
+
+//
+// Client
+//
+
+int runClient(const std::string &socketPath, const std::string_view script, std::ostream &out) {
+    const auto optAddress {makeAddress(socketPath)};
+    if (!optAddress) {
+        std::cerr << "Invalid socket path '" << socketPath << "'" << std::endl;
+        return 1;
+    }
+
+    FileDescriptor fd(::socket(AF_UNIX, SOCK_STREAM, 0));
+    if (!fd.isValid() || !connectTo(fd.get(), optAddress.value())) {
+        std::cerr << "No daemon is listening on '" << socketPath << "', start one with --daemon" << std::endl;
+        return 1;
+    }
+
+    if (!sendAll(fd.get(), script) || ::shutdown(fd.get(), SHUT_WR) != 0) {
+        std::cerr << "Failed to send the script to the daemon" << std::endl;
+        return 1;
+    }
+
+    // Everything up to the end marker is output, the single character behind it is the exit status
+    std::array<char, 4096> buffer {};
+    bool ended {false};
+    while (true) {
+        const auto received {::recv(fd.get(), std::data(buffer), std::size(buffer), 0)};
+        if (received < 0 && errno == EINTR) {
+            continue;
+        }
+        if (received <= 0) {
+            break;
+        }
+
+        const std::string_view chunk(std::data(buffer), size_t(received));
+        if (ended) {
+            return chunk.front() - '0';
+        }
+
+        const auto endPos {chunk.find(END_OF_OUTPUT)};
+        out.write(std::data(chunk), std::streamsize(std::min(endPos, std::size(chunk))));
+        out.flush();
+
+        if (endPos != std::string_view::npos) {
+            if (endPos + 1 < std::size(chunk)) {
+                return chunk[endPos + 1] - '0';
+            }
+            ended = true;
+        }
+    }
+
+    std::cerr << "The connection to the daemon was lost" << std::endl;
+    return 1;
+}
+
+std::string joinCommandLine(const std::vector<std::string> &words) {
+    std::string line;
+    for (const auto &word : words) {
+        if (!line.empty()) {
+            line += ' ';
+        }
+
+        const bool needsQuotes {word.empty() || word.find_first_of(" \t\r\n\v\f\"'\\") != std::string::npos};
+        if (!needsQuotes) {
+            line += word;
+            continue;
+        }
+
+        // Nothing is escaped within single quotes, so single quotes themselves are escaped outside of them
+        line += '\'';
+        for (const char c : word) {
+            if (c == '\'') {
+                line += "'\\''";
+            } else {
+                line += c;
+            }
+        }
+        line += '\'';
+    }
+    return line;
+}
@@ -0,0 +1,37 @@
+#ifndef SHELL_DAEMON_H
+#define SHELL_DAEMON_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+class Shell;
+
+//
+// Daemon mode keeps one shell, and with it the session, connections and caches of the Api, alive for any number of
+// short-lived clients. They talk over a Unix domain socket:
+//
+//  - The client sends a batch script (see parseScript) and shuts down its writing side
+//  - The daemon runs it, streaming the output of every command back as soon as it is complete
+//  - The output ends with a NUL byte followed by the exit status of the script as a single digit
+//
+// Clients are served one after another, consecutive read-only commands of a script still run concurrently.
+//
+
+
+// Located in the runtime directory of the user if there is one, otherwise in /tmp
+std::string getDefaultSocketPath();
+
+// Serves clients until SIGINT or SIGTERM is received, returns the exit status of the daemon
+int runDaemon(Shell &, const std::string &socketPath, const size_t jobs);
+
+// Sends the script to the daemon and writes its output to out, returns the exit status of the script
+int runClient(const std::string &socketPath, const std::string_view script, std::ostream &out);
+
+// Joins the words of a command line into a line of a script, quoting them where the tokenizer needs it
+std::string joinCommandLine(const std::vector<std::string> &words);
+
+
+#endif
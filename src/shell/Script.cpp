@@ -0,0 +1,80 @@
+#include "Script.h"
+#include "Tokenizer.h"
+
+#include "exceptions/ShellException.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+static bool isBlank(const char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+
+std::vector<ScriptCommand> parseScript(std::string &script) {
+    std::vector<ScriptCommand> commands;
+
+    char *const end {script.data() + script.size()};
+    char *lineStart {script.data()};
+
+    for (size_t lineNumber {1}; lineStart < end; ++lineNumber) {
+        char *lineEnd {std::find(lineStart, end, '\n')};
+        char *const nextLine {lineEnd == end ? end : std::next(lineEnd)};
+
+        // Trim the line, which also drops a carriage return of Windows line endings
+        while (lineStart != lineEnd && isBlank(*lineStart)) {
+            ++lineStart;
+        }
+        while (lineEnd != lineStart && isBlank(*std::prev(lineEnd))) {
+            --lineEnd;
+        }
+
+        char *const first {lineStart};
+        const std::string_view line(first, size_t(lineEnd - first));
+        lineStart = nextLine;
+
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+
+        //
+        // Input for the prompts of the preceding command
+        //
+        if (line.front() == '>') {
+            if (commands.empty()) {
+                ScriptCommand orphan;
+                orphan.lineNumber = lineNumber;
+                orphan.error      = "input without a preceding command.";
+                commands.push_back(std::move(orphan));
+            }
+
+            auto input {line.substr(1)};
+            if (!input.empty() && input.front() == ' ') {
+                input.remove_prefix(1);
+            }
+            commands.back().input.append(input).push_back('\n');
+            continue;
+        }
+
+
+        //
+        // Split line into command and arguments
+        //
+        ScriptCommand command;
+        command.lineNumber = lineNumber;
+        try {
+            tokenize(first, lineEnd, command.arguments);
+            if (command.arguments.empty()) {
+                // Whitespace the trimming above does not drop, such as form feeds
+                continue;
+            }
+            command.command = command.arguments.front();
+            command.arguments.erase(std::begin(command.arguments));
+        } catch (const ShellException &ex) {
+            command.error = ex.what();
+        }
+        commands.push_back(std::move(command));
+    }
+
+    return commands;
+}
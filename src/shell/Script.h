@@ -0,0 +1,36 @@
+#ifndef SHELL_SCRIPT_H
+#define SHELL_SCRIPT_H
+
+#include "ShellCommand.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+//
+// A single command of a batch script together with the input it should receive from its prompts.
+// Lines which cannot be executed carry an error message instead of a command.
+//
+struct ScriptCommand {
+    size_t lineNumber {0};
+    std::string_view command;
+    Arguments arguments;
+    std::string input;
+    std::string error;
+};
+
+//
+// Parses a whole batch script up front. Empty lines and lines starting with '#' are ignored.
+// Lines starting with '>' are not commands, but answer the prompts of the preceding command, e.g.
+//
+//   addtrack
+//   > never gonna give you up
+//   > 1
+//
+// The script is tokenized in place, so the commands view into the given buffer and must not outlive it.
+//
+std::vector<ScriptCommand> parseScript(std::string &script);
+
+
+#endif
@@ -1,9 +1,13 @@
 #include "Shell.h"
+#include "Script.h"
+#include "Tokenizer.h"
 
 #include "commands/Exit.h"
 #include "commands/Help.h"
 #include "exceptions/ShellException.h"
 
+#include <deque>
+#include <future>
 #include <iostream>
 #include <sstream>
 
@@ -22,12 +26,12 @@ void Shell::addCommand(const std::string &commandTrigger, std::unique_ptr<ShellC
 }
 
 void Shell::handleInputs(std::istream &in, std::ostream &out) {
-    // Configure all commands
-    std::for_each(std::begin(mCommands), std::end(mCommands),
-                  [&](const auto &kv) { kv.second->configure(out, in, kv.first); });
+    configureCommands(out, in);
 
 
+    // Both buffers are reused for every line, so no allocations are needed once they are large enough
     std::string line;
+    Arguments arguments;
 
     bool exit = false;
     while (!exit) {
@@ -43,61 +47,155 @@ void Shell::handleInputs(std::istream &in, std::ostream &out) {
         //
         // Split line into command and arguments
         //
-        std::string arg;
-        std::string command;
-        std::vector<std::string> arguments;
-        bool first = true;
-
-        std::stringstream lineStream(line);
-        while (!std::getline(lineStream, arg, ' ').fail()) {
-            if (first) {
-                command = arg;
-                first   = false;
-            } else {
-                arguments.push_back(arg);
-            }
+        try {
+            tokenize(line, arguments);
+        } catch (const ShellException &ex) {
+            out << ex.what() << std::endl;
+            continue;
         }
 
-        if (command.empty()) {
+        if (arguments.empty()) {
             continue;
         }
 
+        const auto command {arguments.front()};
+        arguments.erase(std::begin(arguments));
+
 
         //
-        // Check if the command is known
+        // Execute command
         //
-        auto commandIt = mCommands.find(command);
-        if (commandIt == mCommands.cend()) {
-            out << ShellException(ShellExceptionCode::UNKNOWN_COMMAND).what() << std::endl;
+        exit = executeCommand(command, arguments, out, in) == CommandResult::EXIT;
+    }
+}
+
+BatchResult Shell::handleBatch(std::istream &script, std::ostream &out, const size_t jobs) {
+    // The parsed commands view into the buffer, which therefore has to outlive them
+    std::ostringstream content;
+    content << script.rdbuf();
+    std::string buffer {content.str()};
+    const auto commands {parseScript(buffer)};
+
+    // Every execution gets its own streams, the configured ones are never used
+    std::istringstream noInput;
+    configureCommands(out, noInput);
+
+
+    BatchResult batchResult;
+    bool exit {false};
+
+    const auto report = [&](const ScriptCommand &command, const CommandOutput &output) {
+        out << output.text << std::flush;
+
+        ++batchResult.executedCommands;
+        if (output.result == CommandResult::FAILURE) {
+            batchResult.failedLines.push_back(command.lineNumber);
+        }
+        exit = output.result == CommandResult::EXIT;
+    };
+
+    size_t next {0};
+    while (next < std::size(commands) && !exit) {
+        //
+        // Commands which may change any state are executed on their own
+        //
+        if (!isReadOnly(commands[next])) {
+            report(commands[next], executeScriptCommand(commands[next]));
+            ++next;
             continue;
         }
 
 
         //
-        // Execute command
+        // Run a sequence of read-only commands concurrently, reporting their output in script order
         //
+        auto end {next};
+        while (end < std::size(commands) && isReadOnly(commands[end])) {
+            ++end;
+        }
+
+        std::deque<std::future<CommandOutput>> running;
+        for (auto launched {next}; next < end; ++next) {
+            while (launched < end && std::size(running) < std::max<size_t>(jobs, 1)) {
+                const auto &command {commands[launched++]};
+                running.push_back(std::async(std::launch::async, [this, &command] {
+                    return executeScriptCommand(command);
+                }));
+            }
+
+            report(commands[next], running.front().get());
+            running.pop_front();
+        }
+    }
+
+    return batchResult;
+}
+
+
+void Shell::configureCommands(std::ostream &out, std::istream &in) {
+    std::for_each(std::begin(mCommands), std::end(mCommands),
+                  [&](const auto &kv) { kv.second->configure(out, in, kv.first); });
+}
+
+bool Shell::isReadOnly(const ScriptCommand &command) const {
+    const auto commandIt {mCommands.find(command.command)};
+    return commandIt != mCommands.cend() && commandIt->second->isReadOnly(command.arguments);
+}
+
+Shell::CommandResult Shell::executeCommand(const std::string_view command, const Arguments &arguments,
+                                           std::ostream &out, std::istream &in) const {
+    //
+    // Check if the command is known
+    //
+    auto commandIt = mCommands.find(command);
+    if (commandIt == mCommands.cend()) {
+        out << ShellException(ShellExceptionCode::UNKNOWN_COMMAND).what() << std::endl;
+        return CommandResult::FAILURE;
+    }
+
+
+    //
+    // Execute command
+    //
+    try {
         try {
-            try {
-                exit = commandIt->second->execute(arguments);
-            } catch (const ShellException &ex) {
-                switch (ex.getCode()) {
-                case ShellExceptionCode::INVALID_ARGUMENT_VALUE:
-                    out << ex.what() << std::endl;
-                    break;
-
-                case ShellExceptionCode::INVALID_ARGUMENT_FORMAT:
-                case ShellExceptionCode::INVALID_ARGUMENT_NUMBER:
-                    out << ex.what() << std::endl;
-                    out << "Try 'help " << command << "' for further information." << std::endl;
-                    out << std::endl;
-                    break;
-
-                default:
-                    throw;
-                }
+            return commandIt->second->execute(arguments, out, in) ? CommandResult::EXIT : CommandResult::SUCCESS;
+        } catch (const ShellException &ex) {
+            switch (ex.getCode()) {
+            case ShellExceptionCode::INVALID_ARGUMENT_VALUE:
+                out << ex.what() << std::endl;
+                break;
+
+            case ShellExceptionCode::INVALID_ARGUMENT_FORMAT:
+            case ShellExceptionCode::INVALID_ARGUMENT_NUMBER:
+                out << ex.what() << std::endl;
+                out << "Try 'help " << command << "' for further information." << std::endl;
+                out << std::endl;
+                break;
+
+            default:
+                throw;
             }
-        } catch (const std::exception &ex) {
-            out << "Unknown exception occurred: " << ex.what() << std::endl;
         }
+    } catch (const std::exception &ex) {
+        out << "Unknown exception occurred: " << ex.what() << std::endl;
     }
+
+    return CommandResult::FAILURE;
+}
+
+Shell::CommandOutput Shell::executeScriptCommand(const ScriptCommand &command) const {
+    std::ostringstream out;
+    std::istringstream in(command.input);
+
+    CommandOutput output;
+    if (!command.error.empty()) {
+        out << "Line " << command.lineNumber << ": " << command.error << std::endl;
+        output.result = CommandResult::FAILURE;
+    } else {
+        output.result = executeCommand(command.command, command.arguments, out, in);
+    }
+
+    output.text = out.str();
+    return output;
 }
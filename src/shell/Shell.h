@@ -7,10 +7,18 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <vector>
 
 
 class ShellCommand;
-using Commands = std::map<std::string, std::unique_ptr<ShellCommand>>;
+struct ScriptCommand;
+using Commands = std::map<std::string, std::unique_ptr<ShellCommand>, std::less<>>;
+
+struct BatchResult {
+    size_t executedCommands {0};
+    std::vector<size_t> failedLines;
+};
 
 class Shell {
 public:
@@ -18,7 +26,24 @@ public:
     void addCommand(const std::string &, std::unique_ptr<ShellCommand> &&);
     void handleInputs(std::istream &, std::ostream &);
 
+    //
+    // Runs a whole script without prompting. Consecutive read-only commands are executed concurrently on up to
+    // the given number of threads, all other commands on their own. The output is written in script order.
+    //
+    BatchResult handleBatch(std::istream &script, std::ostream &, const size_t jobs);
+
 private:
+    enum class CommandResult { SUCCESS, FAILURE, EXIT };
+    struct CommandOutput {
+        CommandResult result;
+        std::string text;
+    };
+
+    void configureCommands(std::ostream &, std::istream &);
+    bool isReadOnly(const ScriptCommand &) const;
+    CommandResult executeCommand(std::string_view, const Arguments &, std::ostream &, std::istream &) const;
+    CommandOutput executeScriptCommand(const ScriptCommand &) const;
+
     const std::string mPrompt;
     Commands mCommands;
 };
@@ -1,21 +1,63 @@
 #include "ShellCommand.h"
 
 #include "exceptions/ShellException.h"
+#include "utils/Tracer.h"
 
 
-bool ShellCommand::execute(const std::vector<std::string> &args) {
+//
+// Per-thread stream redirection
+//
+
+namespace {
+
+    thread_local std::ostream *tOutStream {nullptr};
+    thread_local std::istream *tInStream {nullptr};
+
+    class StreamRedirection {
+    public:
+        StreamRedirection(std::ostream &out, std::istream &in) : mOutStream(tOutStream), mInStream(tInStream) {
+            tOutStream = &out;
+            tInStream  = &in;
+        }
+
+        ~StreamRedirection() {
+            tOutStream = mOutStream;
+            tInStream  = mInStream;
+        }
+
+        StreamRedirection(const StreamRedirection &) = delete;
+        StreamRedirection &operator=(const StreamRedirection &) = delete;
+
+    private:
+        std::ostream *mOutStream;
+        std::istream *mInStream;
+    };
+
+}  // namespace
+
+
+bool ShellCommand::execute(const Arguments &args) {
 
     if (!mOutStream || !mInStream) {
         throw ShellException(ShellExceptionCode::COMMAND_CONFIGURATION);
     }
 
+    sk::TraceSpan span("command", mCommandTrigger);
+
     doExecute(args);
     return mCloseShell;
 }
 
+bool ShellCommand::execute(const Arguments &args, std::ostream &out, std::istream &in) {
+    StreamRedirection redirection(out, in);
+    return execute(args);
+}
+
+bool ShellCommand::isReadOnly(const Arguments &) const { return false; }
+
 std::string ShellCommand::getTrigger() const { return mCommandTrigger; }
-std::ostream &ShellCommand::getOut() { return *mOutStream; }
-std::istream &ShellCommand::getIn() { return *mInStream; }
+std::ostream &ShellCommand::getOut() { return tOutStream ? *tOutStream : *mOutStream; }
+std::istream &ShellCommand::getIn() { return tInStream ? *tInStream : *mInStream; }
 
 void ShellCommand::closeShell() { mCloseShell = true; }
 
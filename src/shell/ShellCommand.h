@@ -1,11 +1,10 @@
 #ifndef SHELL_COMMAND_H
 #define SHELL_COMMAND_H
 
-#include "Shell.h"
-
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 
@@ -16,6 +15,9 @@ struct ShellCommandDetails {
 };
 
 
+// Arguments view into the line they were read from, they must not be stored by commands
+using Arguments = std::vector<std::string_view>;
+
 class Shell;
 
 class ShellCommand {
@@ -25,9 +27,21 @@ class ShellCommand {
 public:
     virtual ~ShellCommand() = default;
 
-    bool execute(const std::vector<std::string> &);
+    bool execute(const Arguments &);
     virtual ShellCommandDetails getCommandDetails() const = 0;
 
+    //
+    // Executes the command with its input and output redirected to the given streams on the calling thread only.
+    // This allows the same command to run concurrently, e.g. in batch mode.
+    //
+    bool execute(const Arguments &, std::ostream &, std::istream &);
+
+    //
+    // Read-only commands neither change the state of the server nor the one of the client.
+    // Batch mode may run them concurrently to each other.
+    //
+    virtual bool isReadOnly(const Arguments &) const;
+
 protected:
     std::string getTrigger() const;
     std::ostream &getOut();
@@ -35,7 +49,7 @@ protected:
 
     void closeShell();
 
-    virtual void doExecute(const std::vector<std::string> &) = 0;
+    virtual void doExecute(const Arguments &) = 0;
 
 private:
     void configure(std::ostream &, std::istream &, const std::string &trigger);
@@ -0,0 +1,59 @@
+#include "Tokenizer.h"
+
+#include "exceptions/ShellException.h"
+
+
+static bool isWhitespace(const char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+
+void tokenize(char *first, char *last, std::vector<std::string_view> &tokens) {
+    tokens.clear();
+
+    // Resolved characters are written behind 'read', which never overtakes the characters still to be read
+    const char *read {first};
+    char *write {first};
+
+    while (read != last) {
+        if (isWhitespace(*read)) {
+            ++read;
+            continue;
+        }
+
+
+        //
+        // Collect one token, which ends at the first whitespace outside of quotes
+        //
+        char *const tokenStart {write};
+        char quote {'\0'};
+
+        for (; read != last; ++read) {
+            const char c {*read};
+
+            if (quote == '\0' && isWhitespace(c)) {
+                break;
+            }
+
+            if (c == quote) {
+                quote = '\0';
+            } else if (quote == '\0' && (c == '"' || c == '\'')) {
+                quote = c;
+            } else if (c == '\\' && quote != '\'' && read + 1 != last) {
+                *write++ = *++read;
+            } else {
+                *write++ = c;
+            }
+        }
+
+        if (quote != '\0') {
+            throw ShellException(ShellExceptionCode::UNTERMINATED_QUOTE);
+        }
+
+        tokens.emplace_back(tokenStart, size_t(write - tokenStart));
+    }
+}
+
+void tokenize(std::string &line, std::vector<std::string_view> &tokens) {
+    tokenize(line.data(), line.data() + line.size(), tokens);
+}
@@ -0,0 +1,24 @@
+#ifndef SHELL_TOKENIZER_H
+#define SHELL_TOKENIZER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+//
+// Splits an input line into tokens separated by any amount of whitespace. The first token is the command, the others
+// are its arguments.
+//
+//  - "double quotes" and 'single quotes' keep whitespace within a token, e.g. addtrack "never gonna"
+//  - A backslash escapes the following character, except within single quotes
+//  - Quoted and unquoted parts next to each other form a single token, "" is an empty token
+//
+// Quotes and escapes are resolved in place, so the given characters are modified and the resulting tokens view into
+// them. The tokens are only valid as long as the characters are. Throws a ShellException on an unterminated quote.
+//
+void tokenize(char *first, char *last, std::vector<std::string_view> &tokens);
+void tokenize(std::string &line, std::vector<std::string_view> &tokens);
+
+
+#endif
@@ -3,7 +3,7 @@
 
 namespace commands {
 
-    void Exit::doExecute(const std::vector<std::string> & /*args*/) { closeShell(); }
+    void Exit::doExecute(const Arguments & /*args*/) { closeShell(); }
 
     ShellCommandDetails Exit::getCommandDetails() const {
         ShellCommandDetails details;
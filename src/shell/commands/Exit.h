@@ -11,7 +11,7 @@ namespace commands {
         ShellCommandDetails getCommandDetails() const override;
 
     protected:
-        void doExecute(const std::vector<std::string> &) override;
+        void doExecute(const Arguments &) override;
     };
 
 }  // namespace commands
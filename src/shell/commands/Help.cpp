@@ -12,7 +12,7 @@ static void listCommands(std::ostream &out, const Commands &commands) {
     }
 }
 
-static void printCommandHelp(std::ostream &out, const std::string &command, const Commands &commands) {
+static void printCommandHelp(std::ostream &out, const std::string_view command, const Commands &commands) {
     const auto commandIt {commands.find(command)};
     if (commandIt == commands.cend()) {
         throw ShellException(ShellExceptionCode::UNKNOWN_COMMAND);
@@ -32,7 +32,7 @@ namespace commands {
     Help::Help(const Commands &commands) : mCommands(commands) {}
 
 
-    void Help::doExecute(const std::vector<std::string> &arguments) {
+    void Help::doExecute(const Arguments &arguments) {
         if (arguments.size() > 1) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
         }
@@ -44,6 +44,8 @@ namespace commands {
         }
     }
 
+    bool Help::isReadOnly(const Arguments &) const { return true; }
+
     ShellCommandDetails Help::getCommandDetails() const {
         ShellCommandDetails details;
         details.description = "Lists all available commands or prints the help text for one specific command.";
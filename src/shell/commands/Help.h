@@ -1,6 +1,7 @@
 #ifndef CMD_HELP_H
 #define CMD_HELP_H
 
+#include "shell/Shell.h"
 #include "shell/ShellCommand.h"
 
 
@@ -11,9 +12,10 @@ namespace commands {
 
     public:
         ShellCommandDetails getCommandDetails() const override;
+        bool isReadOnly(const Arguments &) const override;
 
     protected:
-        void doExecute(const std::vector<std::string> &) override;
+        void doExecute(const Arguments &) override;
 
     private:
         explicit Help(const Commands &);
@@ -1,5 +1,6 @@
 #include "ApiCommands.h"
 
+#include "utils/Tracer.h"
 #include "utils/utils.h"
 
 #include "api/v1/Api.h"
@@ -17,7 +18,7 @@ using namespace api::v1;
 // Helper functions
 //
 
-static auto parseArgs(const std::vector<std::string> &args) {
+static auto parseArgs(const Arguments &args) {
 
     if (std::size(args) > 2) {
         throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
@@ -49,6 +50,8 @@ static auto parseArgs(const std::vector<std::string> &args) {
 }
 
 static std::optional<std::string> getQueryString(std::ostream &out, std::istream &in) {
+    sk::TraceSpan span("prompt", "getQueryString");
+
 
     out << "Enter the query string: ";
     std::string query;
@@ -59,6 +62,8 @@ static std::optional<std::string> getQueryString(std::ostream &out, std::istream
 }
 
 static std::optional<BaseTrack> selectTrack(std::ostream &out, std::istream &in, const std::vector<BaseTrack> &tracks) {
+    sk::TraceSpan span("prompt", "selectTrack");
+
     const int width {int(std::ceil(std::log10(std::size(tracks) + 1)))};
 
     int trackRank = 1;
@@ -103,7 +108,7 @@ static std::optional<BaseTrack> selectTrack(std::ostream &out, std::istream &in,
 
 namespace commands::v1 {
 
-    void AddTrack::doExecute(const std::vector<std::string> &args) {
+    void AddTrack::doExecute(const Arguments &args) {
 
         const auto [queueType, limit] = parseArgs(args);
         auto api                      = api::v1::Api::getInstance();
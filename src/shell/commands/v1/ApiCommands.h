@@ -3,6 +3,10 @@
 
 #include "shell/ShellCommand.h"
 
+#include "api/v1/QueuesStore.h"
+
+#include <memory>
+
 
 namespace commands::v1 {
 
@@ -12,21 +16,56 @@ namespace commands::v1 {
         ShellCommandDetails getCommandDetails() const override;                                                        \
                                                                                                                        \
     protected:                                                                                                         \
-        void doExecute(const std::vector<std::string> &) override;                                                     \
+        void doExecute(const Arguments &) override;                                                                    \
+    }
+
+// Commands which (at least for some arguments) only query state
+#define DECLARE_READ_ONLY_COMMAND(cmd_name)                                                                            \
+    class cmd_name : public ShellCommand {                                                                             \
+    public:                                                                                                            \
+        ShellCommandDetails getCommandDetails() const override;                                                        \
+        bool isReadOnly(const Arguments &) const override;                                                             \
+                                                                                                                       \
+    protected:                                                                                                         \
+        void doExecute(const Arguments &) override;                                                                    \
     }
 
 
     DECLARE_COMMAND(Login);
-    DECLARE_COMMAND(PrintQueues);
     DECLARE_COMMAND(AddTrack);
     DECLARE_COMMAND(Pause);
     DECLARE_COMMAND(Play);
     DECLARE_COMMAND(Skip);
     DECLARE_COMMAND(Volume);
     DECLARE_COMMAND(Vote);
+    DECLARE_READ_ONLY_COMMAND(ConnectionInfo);
+    DECLARE_READ_ONLY_COMMAND(RequestStatistics);
+    DECLARE_READ_ONLY_COMMAND(SearchCacheInfo);
+    DECLARE_READ_ONLY_COMMAND(AutoRefresh);
+    DECLARE_COMMAND(ImportPlaylist);
+    DECLARE_COMMAND(OrganizeQueues);
+
+
+    //
+    // Remembers the queues it printed last, so that it can print only what changed since then. Plain prints only
+    // ever move that baseline to a newer snapshot, so they may run concurrently; 'print changes' is not read-only.
+    //
+    class PrintQueues : public ShellCommand {
+    public:
+        ShellCommandDetails getCommandDetails() const override;
+        bool isReadOnly(const Arguments &) const override;
+
+    protected:
+        void doExecute(const Arguments &) override;
+
+    private:
+        // Only accessed through the atomic shared_ptr functions
+        std::shared_ptr<const api::v1::QueuesSnapshot> mLastViewed;
+    };
 
 
 #undef DECLARE_COMMAND
+#undef DECLARE_READ_ONLY_COMMAND
 
 }  // namespace commands::v1
 
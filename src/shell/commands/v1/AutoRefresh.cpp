@@ -0,0 +1,80 @@
+#include "ApiCommands.h"
+
+#include "utils/utils.h"
+
+#include "api/v1/Api.h"
+#include "exceptions/ShellException.h"
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static void printPollerStats(std::ostream &out, const Api &api) {
+    const auto optStats {api.getQueuePollerStats()};
+    if (!optStats) {
+        out << "Auto refresh : off" << std::endl;
+        return;
+    }
+
+    const auto &stats {optStats.value()};
+    out << "Auto refresh : on" << std::endl;
+    out << fmt::format("Interval     : {:.1f}s", double(stats.interval.count()) / 1000.0) << std::endl;
+    out << fmt::format("Polls        : {} ({} with changes)", stats.polls, stats.changes) << std::endl;
+    out << fmt::format("Errors       : {}", stats.errors) << std::endl;
+    if (!stats.lastError.empty()) {
+        out << fmt::format("Last error   : {}", stats.lastError) << std::endl;
+    }
+
+    if (const auto snapshot {api.getQueuesSnapshot()}) {
+        out << fmt::format("Queues       : version {}, fetched {:.1f}s ago", snapshot->version,
+                           double(snapshot->getAge().count()) / 1000.0)
+            << std::endl;
+    }
+}
+
+
+//
+// Actual command
+//
+
+namespace commands::v1 {
+
+    void AutoRefresh::doExecute(const Arguments &args) {
+
+        if (std::size(args) > 1) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+
+        auto api = api::v1::Api::getInstance();
+
+        if (std::size(args) == 0) {
+            printPollerStats(getOut(), *api);
+        } else if (args[0] == "on") {
+            if (!api->isQueuePollerRunning()) {
+                api->startQueuePoller();
+            }
+        } else if (args[0] == "off") {
+            api->stopQueuePoller();
+        } else {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+        }
+    }
+
+    // Only printing is read-only, the other actions start or stop the poller
+    bool AutoRefresh::isReadOnly(const Arguments &args) const { return args.empty(); }
+
+    ShellCommandDetails AutoRefresh::getCommandDetails() const {
+        ShellCommandDetails details;
+        details.description = "Keeps the queues up to date in the background, so that print and vote do not have to "
+                              "wait for the server. Polls more often shortly before the playing track ends and less "
+                              "often while nothing changes.";
+        details.usage                           = getTrigger() + " [<state>]";
+        details.parameterDescription["<state>"] = "Starts or stops refreshing. Valid values are: on/off.";
+        return details;
+    }
+
+}  // namespace commands::v1
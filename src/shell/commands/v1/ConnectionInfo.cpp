@@ -0,0 +1,91 @@
+#include "ApiCommands.h"
+
+#include "utils/utils.h"
+
+#include "api/v1/Api.h"
+#include "exceptions/ShellException.h"
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static void printConnectionStats(std::ostream &out, const Api &api) {
+    const auto stats {api.getConnectionStats()};
+
+    // Every request beyond the first one on a connection saved a TCP handshake
+    const double reuseRatio {stats.requestsServed == 0
+                                 ? 0.0
+                                 : double(stats.requestsServed) / double(std::max<size_t>(stats.connectionsOpened, 1))};
+
+    out << fmt::format("Keep-alive         : {}", api.isKeepAlive() ? "on" : "off") << std::endl;
+    out << fmt::format("Connections opened : {}", stats.connectionsOpened) << std::endl;
+    out << fmt::format("Requests served    : {}", stats.requestsServed) << std::endl;
+    out << fmt::format("Reconnects         : {}", stats.reconnects) << std::endl;
+    out << fmt::format("Requests/connection: {:.2f}", reuseRatio) << std::endl;
+
+    const auto coalescing {api.getCoalescingStats()};
+    out << fmt::format("Requests coalesced : {} (of {} requested)", coalescing.coalesced,
+                       coalescing.executed + coalescing.coalesced)
+        << std::endl;
+
+    const auto queues {api.getQueuesFetchStats()};
+    out << fmt::format("Queues reused      : {} not modified, {} unchanged (of {} fetched)", queues.notModified,
+                       queues.unchanged, queues.fetched)
+        << std::endl;
+}
+
+
+//
+// Actual command
+//
+
+namespace commands::v1 {
+
+    void ConnectionInfo::doExecute(const Arguments &args) {
+
+        if (std::size(args) > 2) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+
+        auto api = api::v1::Api::getInstance();
+
+        if (std::size(args) == 0) {
+            printConnectionStats(getOut(), *api);
+            return;
+        }
+
+        const auto action {args[0]};
+        if (action == "reset" && std::size(args) == 1) {
+            api->resetConnectionStats();
+            api->resetCoalescingStats();
+            api->resetQueuesFetchStats();
+        } else if (action == "keepalive" && std::size(args) == 2) {
+            if (args[1] == "on") {
+                api->setKeepAlive(true);
+            } else if (args[1] == "off") {
+                api->setKeepAlive(false);
+            } else {
+                throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+            }
+        } else {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+        }
+    }
+
+    // Only printing is read-only, the other actions change the statistics or settings of the connection
+    bool ConnectionInfo::isReadOnly(const Arguments &args) const { return args.empty(); }
+
+    ShellCommandDetails ConnectionInfo::getCommandDetails() const {
+        ShellCommandDetails details;
+        details.description = "Prints statistics about the connection to the server or changes its settings.";
+        details.usage       = getTrigger() + " [reset | keepalive <state>]";
+        details.parameterDescription["reset"]   = "Resets the connection statistics.";
+        details.parameterDescription["<state>"] = "Keep the connection open between requests. Valid values are: on/off.";
+        return details;
+    }
+
+}  // namespace commands::v1
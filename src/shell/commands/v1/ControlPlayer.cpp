@@ -20,7 +20,7 @@ using namespace api::v1;
 
 namespace commands::v1 {
 
-    void Play::doExecute(const std::vector<std::string> &args) {
+    void Play::doExecute(const Arguments &args) {
 
         if (std::size(args) != 0) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
@@ -30,7 +30,7 @@ namespace commands::v1 {
         api->controlPlayer(PlayerAction::PLAY);
     }
 
-    void Pause::doExecute(const std::vector<std::string> &args) {
+    void Pause::doExecute(const Arguments &args) {
 
         if (std::size(args) != 0) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
@@ -40,7 +40,7 @@ namespace commands::v1 {
         api->controlPlayer(PlayerAction::PAUSE);
     }
 
-    void Skip::doExecute(const std::vector<std::string> &args) {
+    void Skip::doExecute(const Arguments &args) {
 
         if (std::size(args) != 0) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
@@ -50,7 +50,7 @@ namespace commands::v1 {
         api->controlPlayer(PlayerAction::SKIP);
     }
 
-    void Volume::doExecute(const std::vector<std::string> &args) {
+    void Volume::doExecute(const Arguments &args) {
 
         if (std::size(args) != 1) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
@@ -58,7 +58,7 @@ namespace commands::v1 {
 
         auto api = api::v1::Api::getInstance();
 
-        const std::string dir {args[0]};
+        const auto dir {args[0]};
         if (dir == "up") {
             api->controlPlayer(PlayerAction::VOLUME_UP);
         } else if (dir == "down") {
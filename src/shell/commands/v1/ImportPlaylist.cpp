@@ -0,0 +1,349 @@
+#include "ApiCommands.h"
+
+#include "utils/Tracer.h"
+#include "utils/utils.h"
+
+#include "api/v1/Api.h"
+#include "exceptions/ShellException.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <unordered_set>
+
+
+using namespace api::v1;
+
+
+//
+// Helper types
+//
+
+struct ImportEntry {
+    size_t lineNumber;
+
+    // A search pattern, or the id of a track if the line starts with "id:"
+    std::string pattern;
+    bool isTrackId;
+};
+
+struct PendingLookup {
+    size_t index;
+
+    // Not valid for track ids, they do not need to be looked up
+    std::future<std::vector<BaseTrack>> tracks;
+};
+
+struct PendingAdd {
+    size_t index;
+    BaseTrack track;
+
+    // Not valid if the lookup failed, error tells why, or if the track is queued already
+    std::future<void> result;
+    std::string error;
+    bool alreadyQueued;
+};
+
+
+//
+// Helper functions
+//
+
+static constexpr auto TRACK_ID_PREFIX {"id:"};
+static constexpr auto CHECKPOINT_SUFFIX {".checkpoint"};
+
+// Amount of search results to pick the best match from
+static constexpr unsigned int LOOKUP_RESULTS {5};
+
+static auto parseArgs(const Arguments &args) {
+
+    if (std::size(args) < 1 || std::size(args) > 3) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+    }
+
+    const std::string path {args[0]};
+    QueueType queueType {QueueType::NORMAL};
+    bool restart {false};
+
+    for (size_t i {1}; i < std::size(args); ++i) {
+        if (args[i] == "restart") {
+            restart = true;
+        } else {
+            try {
+                queueType = from_string<QueueType>(args[i]);
+            } catch (...) {
+                throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+            }
+        }
+    }
+
+    return std::tuple {path, queueType, restart};
+}
+
+static std::optional<std::vector<ImportEntry>> readEntries(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::vector<ImportEntry> entries;
+    std::string line;
+    for (size_t lineNumber {1}; std::getline(file, line); ++lineNumber) {
+        const auto first {line.find_first_not_of(" \t\r")};
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+        const auto last {line.find_last_not_of(" \t\r")};
+        const auto content {std::string_view(line).substr(first, last - first + 1)};
+
+        const std::string_view trackIdPrefix {TRACK_ID_PREFIX};
+        if (content.substr(0, std::size(trackIdPrefix)) == trackIdPrefix) {
+            entries.push_back({lineNumber, std::string(content.substr(std::size(trackIdPrefix))), true});
+        } else {
+            entries.push_back({lineNumber, std::string(content), false});
+        }
+    }
+    return entries;
+}
+
+// Amount of entries processed by an earlier, interrupted import
+static size_t readCheckpoint(const std::string &checkpointPath) {
+    std::ifstream file(checkpointPath);
+    std::string line;
+    if (!std::getline(file, line)) {
+        return 0;
+    }
+    return sk::to_number<size_t>(line).value_or(0);
+}
+
+// Written to a temporary file first, so that an interruption never leaves a truncated checkpoint behind
+static void writeCheckpoint(const std::string &checkpointPath, const size_t processed) {
+    const auto tempPath {checkpointPath + ".tmp"};
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        file << processed << '\n';
+    }
+    std::rename(tempPath.c_str(), checkpointPath.c_str());
+}
+
+static bool equalsIgnoringCase(const std::string_view str1, const std::string_view str2) {
+    return std::size(str1) == std::size(str2)
+           && std::equal(std::cbegin(str1), std::cend(str1), std::cbegin(str2), [](const char c1, const char c2) {
+                  return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2));
+              });
+}
+
+//
+// Prefers a track whose title or "artist - title" equals the pattern, otherwise trusts the order of the server.
+// The match is picked even if it is queued already, another search result would be a different track.
+//
+static std::optional<BaseTrack> pickBestMatch(const std::vector<BaseTrack> &tracks, const std::string_view pattern) {
+    const auto isExactMatch {[&](const BaseTrack &track) {
+        return equalsIgnoringCase(track.title, pattern)
+               || (track.artist && equalsIgnoringCase(fmt::format("{} - {}", *track.artist, track.title), pattern));
+    }};
+
+    const auto exactIt {std::find_if(std::cbegin(tracks), std::cend(tracks), isExactMatch)};
+    if (exactIt != std::cend(tracks)) {
+        return *exactIt;
+    }
+    if (!tracks.empty()) {
+        return tracks.front();
+    }
+    return std::nullopt;
+}
+
+static std::unordered_set<std::string> getQueuedTrackIds(const Queues &queues) {
+    std::unordered_set<std::string> trackIds;
+    if (queues.currentlyPlaying) {
+        trackIds.insert(queues.currentlyPlaying->trackId);
+    }
+    for (const auto &track : queues.normalQueue) {
+        trackIds.insert(track.trackId);
+    }
+    for (const auto &track : queues.adminQueue) {
+        trackIds.insert(track.trackId);
+    }
+    return trackIds;
+}
+
+static std::string describeTrack(const BaseTrack &track) {
+    if (track.title.empty()) {
+        return fmt::format("track '{}'", track.trackId);
+    }
+    return fmt::format("'{}' by '{}'", track.title, track.artist);
+}
+
+
+//
+// Actual command
+//
+
+namespace commands::v1 {
+
+    void ImportPlaylist::doExecute(const Arguments &args) {
+
+        const auto [path, queueType, restart] = parseArgs(args);
+        auto api                              = api::v1::Api::getInstance();
+
+        if (queueType == QueueType::ADMIN && !api->isAdmin()) {
+            getOut() << "It needs an admin session to add tracks to the admin queue!" << std::endl
+                     << "Try specifying an admin password while logging in." << std::endl;
+            return;
+        }
+
+        const auto optEntries {readEntries(path)};
+        if (!optEntries) {
+            getOut() << fmt::format("The playlist '{}' could not be opened.", path) << std::endl;
+            return;
+        }
+        const auto &entries {optEntries.value()};
+
+        const auto checkpointPath {path + CHECKPOINT_SUFFIX};
+        const auto firstEntry {restart ? 0 : std::min(readCheckpoint(checkpointPath), std::size(entries))};
+        if (firstEntry > 0) {
+            getOut() << fmt::format("Resuming after {} of {} entries, pass 'restart' to start over.", firstEntry,
+                                    std::size(entries))
+                     << std::endl;
+        }
+
+        sk::TraceSpan span("import", "ImportPlaylist", path);
+        const auto startTime {std::chrono::steady_clock::now()};
+
+        // Lookups run ahead of the adds. The admin queue keeps the order of the additions, so its tracks are added
+        // one after another; tracks of the normal queue are ordered by votes and may be added concurrently.
+        const auto window {2 * api->getWorkerCount()};
+        const bool ordered {queueType == QueueType::ADMIN};
+
+        // Includes the tracks picked so far, so that a track is never added twice
+        auto queuedTrackIds {getQueuedTrackIds(*api->getRecentQueues()->queues)};
+
+        std::deque<PendingLookup> lookups;
+        std::deque<PendingAdd> adds;
+        size_t nextEntry {firstEntry};
+        size_t added {0};
+        size_t alreadyQueued {0};
+        std::vector<size_t> failedLines;
+
+        const auto startLookups {[&] {
+            while (std::size(lookups) + std::size(adds) < window && nextEntry < std::size(entries)) {
+                const auto &entry {entries[nextEntry]};
+                if (entry.isTrackId) {
+                    lookups.push_back({nextEntry, {}});
+                } else {
+                    lookups.push_back({nextEntry, api->queryTracksAsync(entry.pattern, LOOKUP_RESULTS)});
+                }
+                ++nextEntry;
+            }
+        }};
+
+        const auto startAdd {[&](PendingLookup &lookup) {
+            const auto &entry {entries[lookup.index]};
+            PendingAdd add {lookup.index, {}, {}, {}, false};
+
+            if (entry.isTrackId) {
+                add.track.trackId = entry.pattern;
+            } else {
+                try {
+                    const auto tracks {lookup.tracks.get()};
+                    const auto optTrack {pickBestMatch(tracks, entry.pattern)};
+                    if (!optTrack) {
+                        add.error = fmt::format("nothing found for '{}'", entry.pattern);
+                        return add;
+                    }
+                    add.track = optTrack.value();
+                } catch (const std::exception &ex) {
+                    add.error = fmt::format("looking up '{}' failed, {}", entry.pattern, ex.what());
+                    return add;
+                }
+            }
+
+            // Also the case for entries added by an interrupted import beyond its checkpoint
+            if (!queuedTrackIds.insert(add.track.trackId).second) {
+                add.alreadyQueued = true;
+                return add;
+            }
+            add.result = api->addTrackAsync(add.track, queueType);
+            return add;
+        }};
+
+        // Entries finish in the order of the playlist, so the checkpoint always covers a complete prefix
+        const auto finishAdd {[&](PendingAdd &add) {
+            if (add.result.valid()) {
+                try {
+                    add.result.get();
+                } catch (const std::exception &ex) {
+                    add.error = fmt::format("adding {} failed, {}", describeTrack(add.track), ex.what());
+                }
+            }
+
+            const auto progress {fmt::format("  {}/{}", add.index + 1, std::size(entries))};
+            if (add.alreadyQueued) {
+                ++alreadyQueued;
+                getOut() << fmt::format("{}: {} is queued already", progress, describeTrack(add.track)) << std::endl;
+            } else if (add.error.empty()) {
+                ++added;
+                getOut() << fmt::format("{}: added {}", progress, describeTrack(add.track)) << std::endl;
+            } else {
+                failedLines.push_back(entries[add.index].lineNumber);
+                getOut() << fmt::format("{}: line {}: {}", progress, entries[add.index].lineNumber, add.error)
+                         << std::endl;
+            }
+            writeCheckpoint(checkpointPath, add.index + 1);
+        }};
+
+        const auto isFinished {[](const PendingAdd &add) {
+            return !add.result.valid() || add.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }};
+
+        startLookups();
+        while (!lookups.empty() || !adds.empty()) {
+            if (!lookups.empty() && !(ordered && !adds.empty())) {
+                adds.push_back(startAdd(lookups.front()));
+                lookups.pop_front();
+            } else {
+                finishAdd(adds.front());
+                adds.pop_front();
+            }
+
+            while (!adds.empty() && isFinished(adds.front())) {
+                finishAdd(adds.front());
+                adds.pop_front();
+            }
+            startLookups();
+        }
+
+        std::remove(checkpointPath.c_str());
+
+        const std::chrono::duration<double> elapsed {std::chrono::steady_clock::now() - startTime};
+        const auto processed {std::size(entries) - firstEntry};
+        getOut() << fmt::format("Added {} of {} tracks to the {} queue in {:.1f}s ({:.1f} tracks/s).", added,
+                                processed, to_string(queueType), elapsed.count(),
+                                elapsed.count() > 0.0 ? double(processed) / elapsed.count() : 0.0)
+                 << std::endl;
+        if (alreadyQueued > 0) {
+            getOut() << fmt::format("{} tracks were queued already.", alreadyQueued) << std::endl;
+        }
+        if (!failedLines.empty()) {
+            getOut() << fmt::format("Failed lines: {}", fmt::join(failedLines, ", ")) << std::endl;
+        }
+    }
+
+    ShellCommandDetails ImportPlaylist::getCommandDetails() const {
+        ShellCommandDetails details;
+        details.description =
+            "Adds every track of a playlist file to a queue. Each line holds a search pattern, whose best match is "
+            "added, or the id of a track prefixed by 'id:'. Empty lines and lines starting with '#' are skipped. "
+            "Tracks are looked up and added concurrently. An interrupted import resumes where it stopped.";
+        details.usage                           = getTrigger() + " <file> [<queue>] [restart]";
+        details.parameterDescription["<file>"]  = "Path of the playlist file.";
+        details.parameterDescription["<queue>"] = "Defines in which queue the tracks should be added. Valid values "
+                                                  "are: normal/admin. [Default: normal]";
+        details.parameterDescription["restart"] = "Ignores the progress of an earlier, interrupted import.";
+        return details;
+    }
+
+}  // namespace commands::v1
@@ -10,7 +10,7 @@
 // Helper functions
 //
 
-static auto parseArgs(const std::vector<std::string> &args) {
+static auto parseArgs(const Arguments &args) {
 
     if (std::size(args) < 2 || std::size(args) > 4) {
         throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
@@ -29,10 +29,10 @@ static auto parseArgs(const std::vector<std::string> &args) {
 
 
     if (std::size(args) > 2) {
-        nickname = args[2];
+        nickname = std::string(args[2]);
 
         if (std::size(args) > 3) {
-            adminPassword = args[3];
+            adminPassword = std::string(args[3]);
         }
     }
 
@@ -46,7 +46,7 @@ static auto parseArgs(const std::vector<std::string> &args) {
 
 namespace commands::v1 {
 
-    void Login::doExecute(const std::vector<std::string> &args) {
+    void Login::doExecute(const Arguments &args) {
 
         const auto [address, port, nickname, adminPassword] = parseArgs(args);
 
@@ -0,0 +1,309 @@
+#include "ApiCommands.h"
+#include "QueueRenderer.h"
+#include "QueueView.h"
+#include "TrackSelection.h"
+
+#include "utils/utils.h"
+
+#include "api/v1/Api.h"
+#include "exceptions/ShellException.h"
+
+#include <algorithm>
+#include <cctype>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
+
+
+using namespace api::v1;
+using namespace commands::v1;
+
+
+//
+// Helper types
+//
+
+// A track of the snapshot the requests are planned from, together with its position for the output
+struct QueuedTrack {
+    QueueType queue;
+    size_t position;
+    const QueueTrack *track;
+};
+
+
+//
+// Helper functions
+//
+
+static QueueType getOtherQueue(const QueueType queueType) {
+    return queueType == QueueType::NORMAL ? QueueType::ADMIN : QueueType::NORMAL;
+}
+
+static std::string describeTrack(const QueuedTrack &entry) {
+    return fmt::format("  {} {}: {} - {}", to_string(entry.queue), entry.position, entry.track->title,
+                       entry.track->artist);
+}
+
+static std::string toLower(const std::string_view str) {
+    std::string lower(str);
+    std::transform(std::begin(lower), std::end(lower), std::begin(lower),
+                   [](const char c) { return char(std::tolower(static_cast<unsigned char>(c))); });
+    return lower;
+}
+
+// Tracks of different albums or releases share their title and artist, but not their id
+static std::string getDuplicateKey(const BaseTrack &track) {
+    return toLower(track.artist.value_or("")) + '\n' + toLower(track.title);
+}
+
+// The selected positions of a queue which also pass the filter, in the order of the queue
+template<typename Track>
+static std::vector<QueuedTrack> selectQueuedTracks(const std::vector<Track> &tracks, const QueueType queueType,
+                                                   const std::vector<size_t> &selection,
+                                                   const QueueViewOptions &options) {
+    const auto filtered {selectTracks(tracks, options, {0, std::size(tracks)})};
+
+    std::vector<QueuedTrack> selected;
+    for (const auto *track : filtered) {
+        const auto index {size_t(track - std::data(tracks))};
+        if (std::binary_search(std::cbegin(selection), std::cend(selection), index)) {
+            selected.push_back({queueType, index + 1, track});
+        }
+    }
+    return selected;
+}
+
+//
+// Only tracks which are not part of the target queue yet need to be moved. The server identifies tracks by their
+// id, so every id is moved only once.
+//
+static std::vector<QueuedTrack> planMoves(std::ostream &out, const Queues &queues, const QueueType source,
+                                          const std::vector<QueuedTrack> &selected) {
+    std::unordered_set<std::string> targetTrackIds;
+    if (source == QueueType::NORMAL) {
+        for (const auto &track : queues.adminQueue) {
+            targetTrackIds.insert(track.trackId);
+        }
+    } else {
+        for (const auto &track : queues.normalQueue) {
+            targetTrackIds.insert(track.trackId);
+        }
+    }
+
+    std::vector<QueuedTrack> moves;
+    for (const auto &entry : selected) {
+        if (targetTrackIds.count(entry.track->trackId) > 0) {
+            out << fmt::format("{}: already in the {} queue", describeTrack(entry), to_string(getOtherQueue(source)))
+                << std::endl;
+            continue;
+        }
+        if (targetTrackIds.insert(entry.track->trackId).second) {
+            moves.push_back(entry);
+        }
+    }
+    return moves;
+}
+
+//
+// Keeps the occurrence which is played first: the currently playing track, then the admin queue, then the normal
+// queue in its order. Copies sharing the id of the kept track cannot be told apart by the server and are skipped.
+//
+static std::vector<QueuedTrack> planDuplicateRemovals(const Queues &queues) {
+    std::unordered_map<std::string, std::string> keptTrackIds;
+    std::unordered_set<std::string> removedTrackIds;
+    std::vector<QueuedTrack> removals;
+
+    const auto visit {[&](const QueuedTrack &entry) {
+        const auto [keptIt, inserted] = keptTrackIds.try_emplace(getDuplicateKey(*entry.track), entry.track->trackId);
+        if (!inserted && keptIt->second != entry.track->trackId
+            && removedTrackIds.insert(entry.track->trackId).second) {
+            removals.push_back(entry);
+        }
+    }};
+
+    if (queues.currentlyPlaying) {
+        keptTrackIds.emplace(getDuplicateKey(*queues.currentlyPlaying), queues.currentlyPlaying->trackId);
+    }
+    for (size_t i {0}; i < std::size(queues.adminQueue); ++i) {
+        visit({QueueType::ADMIN, i + 1, &queues.adminQueue[i]});
+    }
+    for (size_t i {0}; i < std::size(queues.normalQueue); ++i) {
+        visit({QueueType::NORMAL, i + 1, &queues.normalQueue[i]});
+    }
+    return removals;
+}
+
+static std::vector<QueuedTrack> planUserRemovals(const Queues &queues, const std::string_view nickname) {
+    std::unordered_set<std::string> removedTrackIds;
+    std::vector<QueuedTrack> removals;
+
+    const auto visit {[&](const QueuedTrack &entry) {
+        if (entry.track->addedBy == nickname && removedTrackIds.insert(entry.track->trackId).second) {
+            removals.push_back(entry);
+        }
+    }};
+
+    for (size_t i {0}; i < std::size(queues.adminQueue); ++i) {
+        visit({QueueType::ADMIN, i + 1, &queues.adminQueue[i]});
+    }
+    for (size_t i {0}; i < std::size(queues.normalQueue); ++i) {
+        visit({QueueType::NORMAL, i + 1, &queues.normalQueue[i]});
+    }
+    return removals;
+}
+
+//
+// Sends every planned request at once, each one runs on a connection of the worker pool. If the order matters, each
+// request is only sent after the previous one finished. The results are printed in the order of the plan, failures
+// do not stop the remaining requests.
+//
+template<typename SendRequest>
+static void executePlan(std::ostream &out, const std::vector<QueuedTrack> &plan, SendRequest sendRequest,
+                        const std::string_view done, const bool ordered = false) {
+    if (plan.empty()) {
+        out << "Nothing to do." << std::endl;
+        return;
+    }
+
+    std::vector<std::future<void>> requests;
+    requests.reserve(std::size(plan));
+    if (!ordered) {
+        for (const auto &entry : plan) {
+            requests.push_back(sendRequest(*entry.track));
+        }
+    }
+
+    size_t failed {0};
+    for (size_t i {0}; i < std::size(plan); ++i) {
+        if (ordered) {
+            requests.push_back(sendRequest(*plan[i].track));
+        }
+        try {
+            requests[i].get();
+            out << fmt::format("{}: {}", describeTrack(plan[i]), done) << std::endl;
+        } catch (const std::exception &ex) {
+            ++failed;
+            out << fmt::format("{}: failed, {}", describeTrack(plan[i]), ex.what()) << std::endl;
+        }
+    }
+
+    out << fmt::format("{} of {} tracks {}.", std::size(plan) - failed, std::size(plan), done) << std::endl;
+}
+
+// Arguments of 'move': the source queue, followed by an optional selection and filter options in any order
+static auto parseMoveArgs(const Arguments &args) {
+    if (std::size(args) < 2) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+    }
+
+    QueueType source;
+    try {
+        source = from_string<QueueType>(args[1]);
+    } catch (...) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+    }
+
+    std::optional<std::string_view> selection;
+    QueueViewOptions options;
+    for (size_t i {2}; i < std::size(args); ++i) {
+        if (parseViewOption(args[i], options)) {
+            continue;
+        }
+        if (selection) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+        selection = args[i];
+    }
+
+    // The tracks are moved in the order of the queue, sorting them has no meaning
+    if (options.sortKey != QueueSortKey::NONE) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+    }
+
+    return std::tuple {source, selection.value_or("all"), options};
+}
+
+
+//
+// Actual command
+//
+
+namespace commands::v1 {
+
+    void OrganizeQueues::doExecute(const Arguments &args) {
+
+        if (std::size(args) < 1) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+
+        const auto action {args[0]};
+        if (action != "move" && action != "dedupe" && action != "purge") {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+        }
+        if ((action == "dedupe" && std::size(args) != 1) || (action == "purge" && std::size(args) != 2)) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+
+        auto api = api::v1::Api::getInstance();
+        if (!api->isAdmin()) {
+            getOut() << "It needs an admin session to organize the queues!" << std::endl
+                     << "Try specifying an admin password while logging in." << std::endl;
+            return;
+        }
+
+        // Every request is planned from one snapshot, positions in the output refer to it
+        const auto snapshot {api->getRecentQueues()};
+        const auto &queues {*snapshot->queues};
+        QueueRenderer renderer;
+        renderer.renderSnapshotAge(*snapshot);
+        renderer.flush(getOut());
+
+        const auto removeTrack {[&](const BaseTrack &track) { return api->removeTrackAsync(track); }};
+
+        if (action == "move") {
+            const auto [source, selection, options] = parseMoveArgs(args);
+
+            std::vector<QueuedTrack> selected;
+            if (source == QueueType::NORMAL) {
+                const auto positions {parseTrackSelection(selection, std::size(queues.normalQueue))};
+                selected = selectQueuedTracks(queues.normalQueue, source, positions, options);
+            } else {
+                const auto positions {parseTrackSelection(selection, std::size(queues.adminQueue))};
+                selected = selectQueuedTracks(queues.adminQueue, source, positions, options);
+            }
+
+            const auto target {getOtherQueue(source)};
+            const auto moves {planMoves(getOut(), queues, source, selected)};
+
+            // The admin queue is played in the order of the additions, so moves into it are sent one after another
+            executePlan(
+                getOut(), moves, [&](const BaseTrack &track) { return api->moveTrackAsync(track, target); },
+                fmt::format("moved to the {} queue", to_string(target)), target == QueueType::ADMIN);
+        } else if (action == "dedupe") {
+            executePlan(getOut(), planDuplicateRemovals(queues), removeTrack, "removed");
+        } else {
+            executePlan(getOut(), planUserRemovals(queues, args[1]), removeTrack, "removed");
+        }
+    }
+
+    ShellCommandDetails OrganizeQueues::getCommandDetails() const {
+        ShellCommandDetails details;
+        details.description =
+            "Reorganizes the queues in bulk, requires an admin session. The requests are planned from the current "
+            "queues, only tracks which change are sent, and all of them are sent concurrently. Moves into the admin "
+            "queue are sent one after another, so that it keeps the order of the moved tracks.";
+        details.usage = getTrigger() + " move <queue> [<tracks>] [<option>...] | dedupe | purge <nickname>";
+        details.parameterDescription["move"] =
+            "Moves the selected tracks from <queue> to the other queue. Valid values of <queue> are: normal/admin.";
+        details.parameterDescription["<tracks>"] =
+            "Positions of the tracks in <queue>, e.g. 1,3,5-9, or 'all'. [Default: all]";
+        details.parameterDescription["<option>"] =
+            "Filters the selected tracks. Valid values are: artist=<text>, album=<text>, addedby=<text> (matching "
+            "parts ignoring case) and unvoted (tracks without own vote).";
+        details.parameterDescription["dedupe"] =
+            "Removes tracks sharing title and artist with a track played earlier, the first one is kept.";
+        details.parameterDescription["purge"] = "Removes every track added by the user <nickname>.";
+        return details;
+    }
+
+}  // namespace commands::v1
@@ -1,4 +1,6 @@
 #include "ApiCommands.h"
+#include "QueueRenderer.h"
+#include "QueueView.h"
 
 #include "utils/utils.h"
 
@@ -7,15 +9,16 @@
 
 
 using namespace api::v1;
+using namespace commands::v1;
 
 
 //
 // Helper types
 //
 
-enum class RequestedQueues { ALL, NORMAL, ADMIN, CURRENT };
+enum class RequestedQueues { ALL, NORMAL, ADMIN, CURRENT, CHANGES };
 
-static std::optional<RequestedQueues> getRequestedQueues(const std::string &str) {
+static std::optional<RequestedQueues> getRequestedQueues(const std::string_view str) {
     if (str == "all") {
         return RequestedQueues::ALL;
     } else if (str == "normal") {
@@ -24,6 +27,8 @@ static std::optional<RequestedQueues> getRequestedQueues(const std::string &str)
         return RequestedQueues::ADMIN;
     } else if (str == "current") {
         return RequestedQueues::CURRENT;
+    } else if (str == "changes") {
+        return RequestedQueues::CHANGES;
     }
 
     return std::nullopt;
@@ -34,91 +39,77 @@ static std::optional<RequestedQueues> getRequestedQueues(const std::string &str)
 // Helper functions
 //
 
-static void printCurrentlyPlaying(std::ostream &out, const Queues &queues) {
-    if (queues.currentlyPlaying) {
-        const auto &track {queues.currentlyPlaying.value()};
-        out << "Currently playing: " << track.title << " - " << track.artist << std::endl;
+// Without sorting or filtering, the page is rendered straight from the queue
+static void renderNormalQueue(QueueRenderer &renderer, const Queues &queues, const QueueRenderer::Page &page,
+                              const QueueViewOptions &options) {
+    if (options.isEmpty()) {
+        renderer.renderNormalQueue(queues, page);
     } else {
-        out << "Nothing is currently playing" << std::endl;
+        renderer.renderNormalQueue(queues, selectTracks(queues.normalQueue, options, page));
     }
 }
 
-static void printNormalQueue(std::ostream &out, const Queues &queues, const size_t limit) {
-    if (queues.normalQueue.size() > 0) {
-        out << "Normal queue:" << std::endl;
-
-        const auto tracksToPrint {std::min(limit, std::size(queues.normalQueue))};
-        const auto maxWidthTrack {*std::max_element(std::cbegin(queues.normalQueue), std::cend(queues.normalQueue),
-                                                    [&](const auto &t1, const auto &t2) {
-                                                        return fmt::format("{} - {}", t1.title, t1.artist).size()
-                                                               < fmt::format("{} - {}", t2.title, t2.artist).size();
-                                                    })};
-        const auto trackDescWidth {fmt::format("{} - {}", maxWidthTrack.title, maxWidthTrack.artist).size()};
-
-        int trackRank {1};
-        std::for_each_n(std::cbegin(queues.normalQueue), tracksToPrint, [&](const auto &track) {
-            const auto trackDesc {fmt::format("{} - {}", track.title, track.artist)};
-            const auto voteDesc {fmt::format("Votes: {}, {}", track.votes,
-                                             (track.currentVote == 0 ? "Not voted yet" : "Already voted"))};
-            out << fmt::format("  {}: {:{}}    {}", trackRank, trackDesc, trackDescWidth, voteDesc) << std::endl;
-            ++trackRank;
-        });
+static void renderAdminQueue(QueueRenderer &renderer, const Queues &queues, const QueueRenderer::Page &page,
+                             const QueueViewOptions &options) {
+    if (options.isEmpty()) {
+        renderer.renderAdminQueue(queues, page);
     } else {
-        out << "Normal queue is empty." << std::endl;
+        renderer.renderAdminQueue(queues, selectTracks(queues.adminQueue, options, page));
     }
 }
 
-static void printAdminQueue(std::ostream &out, const Queues &queues, const size_t limit) {
-    if (queues.adminQueue.size() > 0) {
-        out << "Admin queue:" << std::endl;
-
-        const auto tracksToPrint {std::min(limit, std::size(queues.adminQueue))};
-
-        int trackRank {1};
-        std::for_each_n(std::cbegin(queues.adminQueue), tracksToPrint, [&](const auto &track) {
-            out << fmt::format("  {}: {} - {}", trackRank, track.title, track.artist) << std::endl;
-            ++trackRank;
-        });
-    } else {
-        out << "Admin queue is empty." << std::endl;
-    }
-}
-
-static void printRequestedQueues(std::ostream &out, const Queues &queues, const RequestedQueues reqQueues,
-                                 const size_t limit) {
+static void renderRequestedQueues(QueueRenderer &renderer, const Queues &queues, const RequestedQueues reqQueues,
+                                  const QueueRenderer::Page &page, const QueueViewOptions &options = {}) {
 
     switch (reqQueues) {
     case RequestedQueues::ALL:
-        printCurrentlyPlaying(out, queues);
-        out << std::endl;
-        printAdminQueue(out, queues, limit);
-        out << std::endl;
-        printNormalQueue(out, queues, limit);
+        renderer.renderCurrentlyPlaying(queues);
+        renderer.renderLine();
+        renderAdminQueue(renderer, queues, page, options);
+        renderer.renderLine();
+        renderNormalQueue(renderer, queues, page, options);
         break;
 
     case RequestedQueues::CURRENT:
-        printCurrentlyPlaying(out, queues);
+        renderer.renderCurrentlyPlaying(queues);
         break;
 
     case RequestedQueues::ADMIN:
-        printAdminQueue(out, queues, limit);
+        renderAdminQueue(renderer, queues, page, options);
         break;
 
     case RequestedQueues::NORMAL:
-        printNormalQueue(out, queues, limit);
+        renderNormalQueue(renderer, queues, page, options);
+        break;
+
+    case RequestedQueues::CHANGES:
+        // Needs the previous queues, see renderChanges
         break;
     }
 }
 
-static auto parseArgs(const std::vector<std::string> &args) {
+static void renderChanges(QueueRenderer &renderer, const QueuesSnapshot *lastViewed, const QueuesSnapshot &snapshot,
+                          const QueueRenderer::Page &page) {
+    // Queues printed before the last login may belong to another server or session
+    if (!lastViewed || lastViewed->storeId != snapshot.storeId) {
+        renderer.renderLine("Nothing has been printed before, printing the queues instead.");
+        renderRequestedQueues(renderer, *snapshot.queues, RequestedQueues::ALL, page);
+        return;
+    }
 
-    if (std::size(args) > 2) {
-        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+    // Snapshots sharing their queues are known to be equal without comparing them
+    if (lastViewed->queues == snapshot.queues) {
+        renderer.renderQueuesDiff({}, page.limit);
+    } else {
+        renderer.renderQueuesDiff(diffQueues(*lastViewed->queues, *snapshot.queues), page.limit);
     }
+}
 
+static auto parseArgs(const Arguments &args) {
 
     RequestedQueues queueType {RequestedQueues::ALL};
-    size_t limit {10};
+    QueueRenderer::Page page;
+    QueueViewOptions options;
 
     if (std::size(args) >= 1) {
         const auto optQueueType {getRequestedQueues(args[0])};
@@ -128,18 +119,55 @@ static auto parseArgs(const std::vector<std::string> &args) {
         queueType = optQueueType.value();
     }
 
-    if (std::size(args) >= 2) {
-        const auto optLimit {sk::to_number<unsigned int>(args[1])};
+    // Options may appear anywhere behind the queue type, the remaining arguments are the limit and the offset
+    std::vector<std::string_view> positionalArgs;
+    for (size_t i {1}; i < std::size(args); ++i) {
+        if (!parseViewOption(args[i], options)) {
+            positionalArgs.push_back(args[i]);
+        }
+    }
+
+    if (std::size(positionalArgs) > 2) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+    }
+    if (queueType == RequestedQueues::CHANGES && !options.isEmpty()) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+    }
+
+    if (std::size(positionalArgs) >= 1) {
+        const auto optLimit {sk::to_number<unsigned int>(positionalArgs[0])};
         if (!optLimit) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
         }
         if (optLimit.value() == 0) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
         }
-        limit = optLimit.value();
+        page.limit = optLimit.value();
+    }
+
+    if (std::size(positionalArgs) >= 2) {
+        const auto optOffset {sk::to_number<unsigned int>(positionalArgs[1])};
+        if (!optOffset) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+        }
+        page.offset = optOffset.value();
     }
 
-    return std::tuple {queueType, limit};
+    return std::tuple {queueType, page, options};
+}
+
+//
+// Concurrent prints may finish in any order, keeping the newest snapshot makes the baseline independent of that.
+// Versions restart with every login, so a snapshot of another store always replaces the baseline.
+//
+static void advanceLastViewed(std::shared_ptr<const QueuesSnapshot> &lastViewed,
+                              const std::shared_ptr<const QueuesSnapshot> &snapshot) {
+    auto current {std::atomic_load(&lastViewed)};
+    while (!current || current->storeId != snapshot->storeId || current->version < snapshot->version) {
+        if (std::atomic_compare_exchange_weak(&lastViewed, &current, snapshot)) {
+            break;
+        }
+    }
 }
 
 
@@ -149,23 +177,44 @@ static auto parseArgs(const std::vector<std::string> &args) {
 
 namespace commands::v1 {
 
-    void PrintQueues::doExecute(const std::vector<std::string> &args) {
+    void PrintQueues::doExecute(const Arguments &args) {
 
-        const auto [queueType, limit] = parseArgs(args);
-        auto api                      = api::v1::Api::getInstance();
+        const auto [queueType, page, options] = parseArgs(args);
+        auto api                              = api::v1::Api::getInstance();
 
-        const auto queues = api->getCurrentQueues();
-        printRequestedQueues(getOut(), queues, queueType, limit);
+        const auto snapshot {api->getRecentQueues()};
+
+        // Reused by every print on this thread, plain prints may run concurrently
+        static thread_local QueueRenderer renderer;
+
+        if (queueType == RequestedQueues::CHANGES) {
+            const auto lastViewed {std::atomic_exchange(&mLastViewed, snapshot)};
+            renderChanges(renderer, lastViewed.get(), *snapshot, page);
+        } else {
+            advanceLastViewed(mLastViewed, snapshot);
+            renderRequestedQueues(renderer, *snapshot->queues, queueType, page, options);
+        }
+        renderer.renderSnapshotAge(*snapshot);
+        renderer.flush(getOut());
     }
 
+    bool PrintQueues::isReadOnly(const Arguments &args) const { return args.empty() || args[0] != "changes"; }
+
     ShellCommandDetails PrintQueues::getCommandDetails() const {
         ShellCommandDetails details;
         details.description = "Queries and prints the contents of any queue and/or the currently playing song.";
-        details.usage       = getTrigger() + " [<queue_type> [<limit>]]";
+        details.usage       = getTrigger() + " [<queue_type> [<limit> [<offset>]] [<option>...]]";
         details.parameterDescription["<queue_type>"] =
-            "Determines the queue to be printed. Valid values are: all/normal/admin/current. [Default: all]";
+            "Determines the queue to be printed. Valid values are: all/normal/admin/current/changes. 'changes' only "
+            "prints what changed since the queues have been printed last. [Default: all]";
         details.parameterDescription["<limit>"] =
             "Limits how many entries of a queue should be printed at max. [Default: 10]";
+        details.parameterDescription["<offset>"] =
+            "Amount of entries skipped at the beginning of a queue, to print the following pages. [Default: 0]";
+        details.parameterDescription["<option>"] =
+            "Sorts or filters the queues, not supported by 'changes'. Valid values are: "
+            "sort=<votes/duration/addedby/title>, artist=<text>, album=<text>, addedby=<text> (matching parts "
+            "ignoring case) and unvoted (tracks without own vote). Votes and durations are sorted descending.";
         return details;
     }
 
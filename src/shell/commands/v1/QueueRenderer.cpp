@@ -0,0 +1,229 @@
+#include "QueueRenderer.h"
+
+#include "utils/Tracer.h"
+#include "utils/utils.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+// Tracks on the page, the range is empty if the page starts behind the end of the queue
+template<typename Track>
+static auto getPageRange(const std::vector<Track> &tracks, const commands::v1::QueueRenderer::Page &page) {
+    const auto first {std::min(page.offset, std::size(tracks))};
+    const auto last {first + std::min(page.limit, std::size(tracks) - first)};
+    return std::pair {first, last};
+}
+
+// Renders rowCount rows, the track of a row is returned by getTrack and has to be part of the queue
+template<typename GetTrack>
+static void renderNormalRows(fmt::memory_buffer &buffer, const std::vector<NormalQueueTrack> &queue,
+                             const size_t rowCount, const GetTrack &getTrack) {
+    // Column width of the descriptions in these rows, measured without allocating
+    const auto getTrackDescSize {[](const NormalQueueTrack &track) {
+        return fmt::formatted_size("{} - {}", track.title, track.artist);
+    }};
+
+    size_t trackDescWidth {0};
+    for (size_t row {0}; row < rowCount; ++row) {
+        trackDescWidth = std::max(trackDescWidth, getTrackDescSize(getTrack(row)));
+    }
+
+    for (size_t row {0}; row < rowCount; ++row) {
+        const NormalQueueTrack &track {getTrack(row)};
+        const auto position {size_t(&track - queue.data()) + 1};
+        fmt::format_to(std::back_inserter(buffer), "  {}: {} - {}{:{}}    Votes: {}, {}\n", position, track.title,
+                       track.artist, "", trackDescWidth - getTrackDescSize(track), track.votes,
+                       (track.currentVote == 0 ? "Not voted yet" : "Already voted"));
+    }
+}
+
+template<typename GetTrack>
+static void renderAdminRows(fmt::memory_buffer &buffer, const std::vector<QueueTrack> &queue, const size_t rowCount,
+                            const GetTrack &getTrack) {
+    for (size_t row {0}; row < rowCount; ++row) {
+        const QueueTrack &track {getTrack(row)};
+        const auto position {size_t(&track - queue.data()) + 1};
+        fmt::format_to(std::back_inserter(buffer), "  {}: {} - {}\n", position, track.title, track.artist);
+    }
+}
+
+
+namespace commands::v1 {
+
+    void QueueRenderer::renderCurrentlyPlaying(const Queues &queues) {
+        sk::TraceSpan span("render", "renderCurrentlyPlaying");
+
+        if (queues.currentlyPlaying) {
+            const auto &track {queues.currentlyPlaying.value()};
+            fmt::format_to(std::back_inserter(mBuffer), "Currently playing: {} - {}\n", track.title, track.artist);
+        } else {
+            renderLine("Nothing is currently playing");
+        }
+    }
+
+    void QueueRenderer::renderNormalQueue(const Queues &queues, const Page &page) {
+        sk::TraceSpan span("render", "renderNormalQueue");
+
+        const auto &tracks {queues.normalQueue};
+        if (tracks.empty()) {
+            renderLine("Normal queue is empty.");
+            return;
+        }
+
+        const auto [first, last] {getPageRange(tracks, page)};
+        if (first == last) {
+            fmt::format_to(std::back_inserter(mBuffer), "Normal queue has only {} tracks.\n", std::size(tracks));
+            return;
+        }
+
+        renderLine("Normal queue:");
+        renderNormalRows(mBuffer, tracks, last - first,
+                         [&, first = first](const size_t row) -> const NormalQueueTrack & {
+                             return tracks[first + row];
+                         });
+    }
+
+    void QueueRenderer::renderNormalQueue(const Queues &queues, const std::vector<const NormalQueueTrack *> &tracks) {
+        sk::TraceSpan span("render", "renderNormalQueue");
+
+        if (tracks.empty()) {
+            renderLine(queues.normalQueue.empty() ? "Normal queue is empty." : "No track of the normal queue matches.");
+            return;
+        }
+
+        renderLine("Normal queue:");
+        renderNormalRows(mBuffer, queues.normalQueue, std::size(tracks),
+                         [&](const size_t row) -> const NormalQueueTrack & { return *tracks[row]; });
+    }
+
+    void QueueRenderer::renderAdminQueue(const Queues &queues, const Page &page) {
+        sk::TraceSpan span("render", "renderAdminQueue");
+
+        const auto &tracks {queues.adminQueue};
+        if (tracks.empty()) {
+            renderLine("Admin queue is empty.");
+            return;
+        }
+
+        const auto [first, last] {getPageRange(tracks, page)};
+        if (first == last) {
+            fmt::format_to(std::back_inserter(mBuffer), "Admin queue has only {} tracks.\n", std::size(tracks));
+            return;
+        }
+
+        renderLine("Admin queue:");
+        renderAdminRows(mBuffer, tracks, last - first,
+                        [&, first = first](const size_t row) -> const QueueTrack & { return tracks[first + row]; });
+    }
+
+    void QueueRenderer::renderAdminQueue(const Queues &queues, const std::vector<const QueueTrack *> &tracks) {
+        sk::TraceSpan span("render", "renderAdminQueue");
+
+        if (tracks.empty()) {
+            renderLine(queues.adminQueue.empty() ? "Admin queue is empty." : "No track of the admin queue matches.");
+            return;
+        }
+
+        renderLine("Admin queue:");
+        renderAdminRows(mBuffer, queues.adminQueue, std::size(tracks),
+                        [&](const size_t row) -> const QueueTrack & { return *tracks[row]; });
+    }
+
+    void QueueRenderer::renderQueuesDiff(const QueuesDiff &diff, const size_t limit) {
+        sk::TraceSpan span("render", "renderQueuesDiff");
+
+        const auto out {std::back_inserter(mBuffer)};
+
+        if (diff.empty()) {
+            renderLine("No changes since the last view.");
+            return;
+        }
+
+        if (diff.playingChanged) {
+            if (diff.currentlyPlaying) {
+                const auto &track {diff.currentlyPlaying.value()};
+                fmt::format_to(out, "Currently playing: {} - {}{}\n", track.title, track.artist,
+                               track.playing ? "" : " (paused)");
+            } else {
+                renderLine("Nothing is currently playing");
+            }
+        }
+
+        for (const auto queueType : {QueueType::ADMIN, QueueType::NORMAL}) {
+            const auto isInQueue {[&](const QueueChange &change) { return change.queue == queueType; }};
+            const auto changeCount {
+                size_t(std::count_if(std::cbegin(diff.changes), std::cend(diff.changes), isInQueue))};
+            if (changeCount == 0) {
+                continue;
+            }
+
+            renderLine(queueType == QueueType::ADMIN ? "Admin queue:" : "Normal queue:");
+
+            size_t rendered {0};
+            for (const auto &change : diff.changes) {
+                if (!isInQueue(change)) {
+                    continue;
+                }
+                if (rendered++ == limit) {
+                    fmt::format_to(out, "  ... and {} more changes\n", changeCount - limit);
+                    break;
+                }
+
+                const auto &track {change.track};
+                switch (change.type) {
+                case QueueChangeType::ADDED:
+                    fmt::format_to(out, "  + {}: {} - {}", change.newPosition.value() + 1, track.title, track.artist);
+                    break;
+                case QueueChangeType::REMOVED:
+                    fmt::format_to(out, "  - {}: {} - {}", change.oldPosition.value() + 1, track.title, track.artist);
+                    break;
+                case QueueChangeType::CHANGED:
+                    fmt::format_to(out, "  ~ {}: {} - {}", change.newPosition.value() + 1, track.title, track.artist);
+                    if (change.moved) {
+                        fmt::format_to(out, ", moved from {}", change.oldPosition.value() + 1);
+                    }
+                    break;
+                }
+
+                if (queueType == QueueType::NORMAL && change.type != QueueChangeType::REMOVED) {
+                    if (change.oldVotes != change.newVotes && change.type == QueueChangeType::CHANGED) {
+                        fmt::format_to(out, ", votes: {} -> {}", change.oldVotes, change.newVotes);
+                    } else {
+                        fmt::format_to(out, ", votes: {}", change.newVotes);
+                    }
+                }
+                renderLine();
+            }
+        }
+    }
+
+    void QueueRenderer::renderSnapshotAge(const QueuesSnapshot &snapshot) {
+        const auto age {snapshot.getAge()};
+        if (age < std::chrono::seconds(1)) {
+            return;
+        }
+
+        fmt::format_to(std::back_inserter(mBuffer), "(Queues version {}, fetched {:.1f}s ago)\n", snapshot.version,
+                       double(age.count()) / 1000.0);
+    }
+
+    void QueueRenderer::renderLine(const std::string_view line) {
+        mBuffer.append(line.data(), line.data() + line.size());
+        mBuffer.push_back('\n');
+    }
+
+    void QueueRenderer::flush(std::ostream &out) {
+        out.write(mBuffer.data(), std::streamsize(mBuffer.size()));
+        out.flush();
+        mBuffer.clear();
+    }
+
+}  // namespace commands::v1
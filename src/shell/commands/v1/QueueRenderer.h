@@ -0,0 +1,55 @@
+#ifndef CMD_APIV1_QUEUE_RENDERER_H
+#define CMD_APIV1_QUEUE_RENDERER_H
+
+#include "api/v1/ApiTypes.h"
+#include "api/v1/QueueDiff.h"
+#include "api/v1/QueuesStore.h"
+
+#include <fmt/format.h>
+
+#include <ostream>
+#include <vector>
+
+
+namespace commands::v1 {
+
+    //
+    // Renders the contents of the queues into a buffer, which is written to a stream at once by flush.
+    // Queues are rendered page by page and only the tracks on the page are looked at (e.g. to align the columns),
+    // so the time taken grows with the rows shown rather than with the size of the queue.
+    // The buffer keeps its memory between renderings, reusing a renderer avoids allocating it over and over.
+    //
+    class QueueRenderer {
+    public:
+        struct Page {
+            size_t offset {0};
+            size_t limit {10};
+        };
+
+        void renderCurrentlyPlaying(const api::v1::Queues &queues);
+        void renderNormalQueue(const api::v1::Queues &queues, const Page &page);
+        void renderAdminQueue(const api::v1::Queues &queues, const Page &page);
+
+        // Renders a selection of tracks of the queue, e.g. sorted or filtered ones
+        void renderNormalQueue(const api::v1::Queues &queues,
+                               const std::vector<const api::v1::NormalQueueTrack *> &tracks);
+        void renderAdminQueue(const api::v1::Queues &queues, const std::vector<const api::v1::QueueTrack *> &tracks);
+
+        // Renders at most limit changes per queue
+        void renderQueuesDiff(const api::v1::QueuesDiff &diff, const size_t limit);
+
+        // Mentions how old the snapshot is, unless it has just been fetched
+        void renderSnapshotAge(const api::v1::QueuesSnapshot &snapshot);
+
+        void renderLine(const std::string_view line = {});
+
+        // Writes everything rendered so far and empties the buffer
+        void flush(std::ostream &out);
+
+    private:
+        fmt::memory_buffer mBuffer;
+    };
+
+}  // namespace commands::v1
+
+#endif
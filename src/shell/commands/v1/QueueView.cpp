@@ -0,0 +1,197 @@
+#include "QueueView.h"
+
+#include "utils/Tracer.h"
+
+#include "exceptions/ShellException.h"
+
+#include <algorithm>
+#include <cctype>
+#include <functional>
+#include <type_traits>
+
+
+using namespace api::v1;
+using namespace commands::v1;
+
+
+//
+// Helper functions
+//
+
+static bool containsIgnoringCase(const std::string_view str, const std::string_view pattern) {
+    if (pattern.empty()) {
+        return true;
+    }
+
+    const auto equalIgnoringCase {[](const char c1, const char c2) {
+        return std::tolower(static_cast<unsigned char>(c1)) == std::tolower(static_cast<unsigned char>(c2));
+    }};
+    return std::search(std::cbegin(str), std::cend(str), std::cbegin(pattern), std::cend(pattern), equalIgnoringCase)
+           != std::cend(str);
+}
+
+// Missing values only match an empty pattern
+static bool optionalContainsIgnoringCase(const std::optional<std::string> &str, const std::string_view pattern) {
+    return pattern.empty() || (str && containsIgnoringCase(str.value(), pattern));
+}
+
+template<typename Track>
+static bool matchesFilter(const Track &track, const QueueFilter &filter) {
+    if constexpr (std::is_same_v<Track, NormalQueueTrack>) {
+        if (filter.notVoted && track.currentVote != 0) {
+            return false;
+        }
+    }
+
+    return optionalContainsIgnoringCase(track.artist, filter.artist)
+           && optionalContainsIgnoringCase(track.album, filter.album)
+           && containsIgnoringCase(track.addedBy, filter.addedBy);
+}
+
+// Tracks which are equal regarding the sort key keep the order of the queue
+template<typename Track>
+static bool isOrderedBefore(const Track *lhs, const Track *rhs, const QueueSortKey sortKey) {
+    switch (sortKey) {
+    case QueueSortKey::VOTES:
+        if constexpr (std::is_same_v<Track, NormalQueueTrack>) {
+            if (lhs->votes != rhs->votes) {
+                return lhs->votes > rhs->votes;
+            }
+        }
+        break;
+
+    case QueueSortKey::DURATION:
+        if (lhs->duration != rhs->duration) {
+            return lhs->duration > rhs->duration;
+        }
+        break;
+
+    case QueueSortKey::ADDED_BY:
+        if (const auto order {lhs->addedBy.compare(rhs->addedBy)}; order != 0) {
+            return order < 0;
+        }
+        break;
+
+    case QueueSortKey::TITLE:
+        if (const auto order {lhs->title.compare(rhs->title)}; order != 0) {
+            return order < 0;
+        }
+        break;
+
+    case QueueSortKey::NONE:
+        break;
+    }
+
+    // Both point into the same queue
+    return std::less<const Track *>()(lhs, rhs);
+}
+
+template<typename Track>
+static std::vector<const Track *> selectPage(const std::vector<Track> &tracks, const QueueViewOptions &options,
+                                             const QueueRenderer::Page &page) {
+    sk::TraceSpan span("render", "selectTracks");
+
+    // Both are capped, so that a huge limit cannot overflow
+    const auto pageEnd {std::min(page.offset, std::size(tracks)) + std::min(page.limit, std::size(tracks))};
+
+    std::vector<const Track *> selected;
+    if (options.sortKey == QueueSortKey::NONE) {
+        for (const auto &track : tracks) {
+            if (std::size(selected) == pageEnd) {
+                break;
+            }
+            if (matchesFilter(track, options.filter)) {
+                selected.push_back(&track);
+            }
+        }
+    } else {
+        selected.reserve(std::size(tracks));
+        for (const auto &track : tracks) {
+            if (matchesFilter(track, options.filter)) {
+                selected.push_back(&track);
+            }
+        }
+
+        // Top-k: the tracks behind the page stay unsorted
+        const auto sortedEnd {std::next(std::begin(selected), std::ptrdiff_t(std::min(pageEnd, std::size(selected))))};
+        std::partial_sort(std::begin(selected), sortedEnd, std::end(selected), [&](const Track *lhs, const Track *rhs) {
+            return isOrderedBefore(lhs, rhs, options.sortKey);
+        });
+        selected.erase(sortedEnd, std::end(selected));
+    }
+
+    selected.erase(std::begin(selected),
+                   std::next(std::begin(selected), std::ptrdiff_t(std::min(page.offset, std::size(selected)))));
+    return selected;
+}
+
+
+//
+// Options
+//
+
+bool QueueFilter::isEmpty() const noexcept { return artist.empty() && album.empty() && addedBy.empty() && !notVoted; }
+
+bool QueueViewOptions::isEmpty() const noexcept { return sortKey == QueueSortKey::NONE && filter.isEmpty(); }
+
+std::optional<QueueSortKey> commands::v1::parseSortKey(const std::string_view str) {
+    if (str == "votes") {
+        return QueueSortKey::VOTES;
+    } else if (str == "duration") {
+        return QueueSortKey::DURATION;
+    } else if (str == "addedby") {
+        return QueueSortKey::ADDED_BY;
+    } else if (str == "title") {
+        return QueueSortKey::TITLE;
+    }
+
+    return std::nullopt;
+}
+
+bool commands::v1::parseViewOption(const std::string_view arg, QueueViewOptions &options) {
+    if (arg == "unvoted") {
+        options.filter.notVoted = true;
+        return true;
+    }
+
+    const auto separatorPos {arg.find('=')};
+    if (separatorPos == std::string_view::npos) {
+        return false;
+    }
+
+    const auto key {arg.substr(0, separatorPos)};
+    const auto value {arg.substr(separatorPos + 1)};
+    if (key == "sort") {
+        const auto optSortKey {parseSortKey(value)};
+        if (!optSortKey) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+        }
+        options.sortKey = optSortKey.value();
+    } else if (key == "artist") {
+        options.filter.artist = value;
+    } else if (key == "album") {
+        options.filter.album = value;
+    } else if (key == "addedby") {
+        options.filter.addedBy = value;
+    } else {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+    }
+    return true;
+}
+
+
+//
+// Selection
+//
+
+std::vector<const NormalQueueTrack *> commands::v1::selectTracks(const std::vector<NormalQueueTrack> &tracks,
+                                                                 const QueueViewOptions &options,
+                                                                 const QueueRenderer::Page &page) {
+    return selectPage(tracks, options, page);
+}
+
+std::vector<const QueueTrack *> commands::v1::selectTracks(const std::vector<QueueTrack> &tracks,
+                                                           const QueueViewOptions &options,
+                                                           const QueueRenderer::Page &page) {
+    return selectPage(tracks, options, page);
+}
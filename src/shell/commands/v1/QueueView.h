@@ -0,0 +1,62 @@
+#ifndef CMD_APIV1_QUEUE_VIEW_H
+#define CMD_APIV1_QUEUE_VIEW_H
+
+#include "QueueRenderer.h"
+
+#include "api/v1/ApiTypes.h"
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace commands::v1 {
+
+    // Votes and durations are sorted in descending, titles and nicknames in ascending order
+    enum class QueueSortKey { NONE, VOTES, DURATION, ADDED_BY, TITLE };
+
+    struct QueueFilter {
+        // Substrings, compared ignoring case; empty ones match every track
+        std::string artist;
+        std::string album;
+        std::string addedBy;
+
+        // Only tracks without a vote of this session, applies to the normal queue only
+        bool notVoted {false};
+
+        bool isEmpty() const noexcept;
+    };
+
+    struct QueueViewOptions {
+        // Sorting by votes applies to the normal queue only
+        QueueSortKey sortKey {QueueSortKey::NONE};
+        QueueFilter filter;
+
+        bool isEmpty() const noexcept;
+    };
+
+    std::optional<QueueSortKey> parseSortKey(const std::string_view str);
+
+    //
+    // Parses an option like 'sort=votes', 'artist=<text>' or 'unvoted' into the options. Returns false if the argument
+    // is no option at all and throws a ShellException if it is a malformed one.
+    //
+    bool parseViewOption(const std::string_view arg, QueueViewOptions &options);
+
+
+    //
+    // Selects the tracks on a page of the sorted and filtered queue. The result points into the queue.
+    // Only the tracks up to the end of the page are sorted (partial selection), and without a sort key the queue is
+    // only scanned until the page is complete.
+    //
+    std::vector<const api::v1::NormalQueueTrack *> selectTracks(const std::vector<api::v1::NormalQueueTrack> &tracks,
+                                                                const QueueViewOptions &options,
+                                                                const QueueRenderer::Page &page);
+    std::vector<const api::v1::QueueTrack *> selectTracks(const std::vector<api::v1::QueueTrack> &tracks,
+                                                          const QueueViewOptions &options,
+                                                          const QueueRenderer::Page &page);
+
+}  // namespace commands::v1
+
+#endif
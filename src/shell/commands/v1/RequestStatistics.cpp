@@ -0,0 +1,101 @@
+#include "ApiCommands.h"
+
+#include "utils/utils.h"
+
+#include "api/v1/Api.h"
+#include "exceptions/ShellException.h"
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static std::string formatBytes(const uint64_t bytes) {
+    if (bytes < 1024) {
+        return fmt::format("{} B", bytes);
+    } else if (bytes < 1024 * 1024) {
+        return fmt::format("{:.1f} KiB", double(bytes) / 1024.0);
+    } else {
+        return fmt::format("{:.1f} MiB", double(bytes) / (1024.0 * 1024.0));
+    }
+}
+
+static void printHistogram(std::ostream &out, const std::string &name, const sk::Histogram &histogram) {
+    // Recorded in microseconds, printed in milliseconds
+    const auto ms {[](const uint64_t us) { return double(us) / 1000.0; }};
+
+    out << fmt::format("  {:<9} {:>7} {:>9.2f} {:>9.2f} {:>9.2f} {:>9.2f}", name, histogram.getCount(),
+                       ms(histogram.getPercentile(50)), ms(histogram.getPercentile(95)),
+                       ms(histogram.getPercentile(99)), ms(histogram.getMax()))
+        << std::endl;
+}
+
+static void printRequestStats(std::ostream &out, const Api &api) {
+    const auto endpoints {api.getRequestStats()};
+    if (endpoints.empty()) {
+        out << "No requests recorded yet." << std::endl;
+        return;
+    }
+
+    bool firstEndpoint {true};
+    for (const auto &[name, stats] : endpoints) {
+        if (!firstEndpoint) {
+            out << std::endl;
+        }
+        firstEndpoint = false;
+
+        out << fmt::format("{}: {} requests, {} failed, {} sent, {} received", name, stats.requests, stats.failures,
+                           formatBytes(stats.bytesSent), formatBytes(stats.bytesReceived))
+            << std::endl;
+        out << fmt::format("  {:<9} {:>7} {:>9} {:>9} {:>9} {:>9}", "phase", "count", "p50 ms", "p95 ms", "p99 ms",
+                           "max ms")
+            << std::endl;
+
+        for (size_t i {0}; i < REQUEST_PHASE_COUNT; ++i) {
+            printHistogram(out, to_string(static_cast<RequestPhase>(i)), stats.phases[i]);
+        }
+        printHistogram(out, "total", stats.total);
+    }
+}
+
+
+//
+// Actual command
+//
+
+namespace commands::v1 {
+
+    void RequestStatistics::doExecute(const Arguments &args) {
+
+        if (std::size(args) > 1) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+
+        auto api = api::v1::Api::getInstance();
+
+        if (std::size(args) == 0) {
+            printRequestStats(getOut(), *api);
+        } else if (args[0] == "reset") {
+            api->resetRequestStats();
+        } else {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+        }
+    }
+
+    // Only printing is read-only, resetting changes the recorded statistics
+    bool RequestStatistics::isReadOnly(const Arguments &args) const { return args.empty(); }
+
+    ShellCommandDetails RequestStatistics::getCommandDetails() const {
+        ShellCommandDetails details;
+        details.description = "Prints request counts, transferred bytes and latency percentiles per endpoint. "
+                              "Each request is split into connect, send, wait (for the first byte), receive and "
+                              "parse.";
+        details.usage                         = getTrigger() + " [reset]";
+        details.parameterDescription["reset"] = "Discards all recorded statistics.";
+        return details;
+    }
+
+}  // namespace commands::v1
@@ -0,0 +1,68 @@
+#include "ApiCommands.h"
+
+#include "utils/utils.h"
+
+#include "api/v1/Api.h"
+#include "exceptions/ShellException.h"
+
+
+using namespace api::v1;
+
+
+//
+// Helper functions
+//
+
+static void printSearchCacheStats(std::ostream &out, const Api &api) {
+    const auto stats {api.getSearchCacheStats()};
+
+    const auto lookups {stats.hits + stats.misses};
+    const double hitRatio {lookups == 0 ? 0.0 : double(stats.hits) / double(lookups)};
+
+    out << fmt::format("Entries      : {} ({:.1f} KiB)", stats.entries, double(stats.bytes) / 1024.0) << std::endl;
+    out << fmt::format("Hits         : {} ({} without results)", stats.hits, stats.negativeHits) << std::endl;
+    out << fmt::format("Misses       : {}", stats.misses) << std::endl;
+    out << fmt::format("Hit ratio    : {:.1f}%", hitRatio * 100.0) << std::endl;
+    out << fmt::format("Evictions    : {}", stats.evictions) << std::endl;
+    out << fmt::format("Expirations  : {}", stats.expirations) << std::endl;
+}
+
+
+//
+// Actual command
+//
+
+namespace commands::v1 {
+
+    void SearchCacheInfo::doExecute(const Arguments &args) {
+
+        if (std::size(args) > 1) {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
+        }
+
+        auto api = api::v1::Api::getInstance();
+
+        if (std::size(args) == 0) {
+            printSearchCacheStats(getOut(), *api);
+        } else if (args[0] == "clear") {
+            api->clearSearchCache();
+        } else if (args[0] == "reset") {
+            api->resetSearchCacheStats();
+        } else {
+            throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+        }
+    }
+
+    // Only printing is read-only, the other actions change the cache or its statistics
+    bool SearchCacheInfo::isReadOnly(const Arguments &args) const { return args.empty(); }
+
+    ShellCommandDetails SearchCacheInfo::getCommandDetails() const {
+        ShellCommandDetails details;
+        details.description = "Prints statistics about the cache of search results or clears it.";
+        details.usage       = getTrigger() + " [clear | reset]";
+        details.parameterDescription["clear"] = "Drops all cached search results.";
+        details.parameterDescription["reset"] = "Resets the cache statistics.";
+        return details;
+    }
+
+}  // namespace commands::v1
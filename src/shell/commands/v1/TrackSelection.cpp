@@ -0,0 +1,61 @@
+#include "TrackSelection.h"
+
+#include "utils/utils.h"
+
+#include "exceptions/ShellException.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+//
+// Helper functions
+//
+
+static size_t parsePosition(const std::string_view str, const size_t trackCount) {
+    const auto optPosition {sk::to_number<size_t>(str)};
+    if (!optPosition) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_FORMAT);
+    }
+    if (optPosition.value() == 0 || optPosition.value() > trackCount) {
+        throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+    }
+    return optPosition.value();
+}
+
+
+//
+// Parsing
+//
+
+std::vector<size_t> commands::v1::parseTrackSelection(const std::string_view selection, const size_t trackCount) {
+    std::vector<bool> selected(trackCount, selection == "all");
+
+    if (selection != "all") {
+        std::string_view remaining {selection};
+        while (!remaining.empty()) {
+            const auto separatorPos {remaining.find(',')};
+            const auto item {remaining.substr(0, separatorPos)};
+            remaining = separatorPos == std::string_view::npos ? std::string_view() : remaining.substr(separatorPos + 1);
+
+            const auto rangePos {item.find('-')};
+            const auto first {parsePosition(item.substr(0, rangePos), trackCount)};
+            const auto last {rangePos == std::string_view::npos ? first
+                                                                : parsePosition(item.substr(rangePos + 1), trackCount)};
+            if (first > last) {
+                throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
+            }
+
+            std::fill(std::next(std::begin(selected), std::ptrdiff_t(first - 1)),
+                      std::next(std::begin(selected), std::ptrdiff_t(last)), true);
+        }
+    }
+
+    std::vector<size_t> indices;
+    for (size_t i {0}; i < trackCount; ++i) {
+        if (selected[i]) {
+            indices.push_back(i);
+        }
+    }
+    return indices;
+}
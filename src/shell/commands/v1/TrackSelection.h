@@ -0,0 +1,19 @@
+#ifndef CMD_APIV1_TRACK_SELECTION_H
+#define CMD_APIV1_TRACK_SELECTION_H
+
+#include <string_view>
+#include <vector>
+
+
+namespace commands::v1 {
+
+    //
+    // Parses a selection of positions within a queue of trackCount tracks, e.g. "all" or "1,3,5-9".
+    // Positions are one based and ranges include both ends. Returns zero based indices in ascending order, each one
+    // only once. Throws a ShellException if the selection is malformed or a position is out of range.
+    //
+    std::vector<size_t> parseTrackSelection(const std::string_view selection, const size_t trackCount);
+
+}  // namespace commands::v1
+
+#endif
@@ -1,10 +1,14 @@
 #include "ApiCommands.h"
+#include "QueueRenderer.h"
+#include "TrackSelection.h"
 
 #include "utils/utils.h"
 
 #include "api/v1/Api.h"
 #include "exceptions/ShellException.h"
 
+#include <future>
+
 
 using namespace api::v1;
 
@@ -117,6 +121,48 @@ static std::optional<NormalQueueTrack> revokeVoteForTrack(std::ostream &out, std
     return tracks[trackNumber - 1];
 }
 
+//
+// Places or revokes the votes for the selected tracks at once, each request runs on a connection of the worker pool.
+// Tracks which do not need a request are skipped, listing them unless they have been selected through 'all'.
+//
+static void voteForTracks(std::ostream &out, Api &api, const std::vector<NormalQueueTrack> &tracks,
+                          const std::vector<size_t> &selection, const api::v1::Vote vote, const bool listSkipped) {
+    const bool upVote {vote == api::v1::Vote::UP_VOTE};
+
+    std::vector<std::pair<size_t, std::future<void>>> requests;
+    for (const auto index : selection) {
+        const auto &track {tracks[index]};
+        if ((track.currentVote != 0) == upVote) {
+            if (listSkipped) {
+                out << fmt::format("  {}: {} - {}: {}", index + 1, track.title, track.artist,
+                                   upVote ? "already voted" : "not voted")
+                    << std::endl;
+            }
+            continue;
+        }
+        requests.emplace_back(index, api.voteTrackAsync(track, vote));
+    }
+
+    size_t failed {0};
+    for (auto &[index, request] : requests) {
+        const auto &track {tracks[index]};
+        try {
+            request.get();
+            out << fmt::format("  {}: {} - {}: {}", index + 1, track.title, track.artist,
+                               upVote ? "vote placed" : "vote revoked")
+                << std::endl;
+        } catch (const std::exception &ex) {
+            ++failed;
+            out << fmt::format("  {}: {} - {}: failed, {}", index + 1, track.title, track.artist, ex.what())
+                << std::endl;
+        }
+    }
+
+    out << fmt::format("{} of {} votes {}.", std::size(requests) - failed, std::size(requests),
+                       upVote ? "placed" : "revoked")
+        << std::endl;
+}
+
 
 //
 // Actual command
@@ -124,22 +170,35 @@ static std::optional<NormalQueueTrack> revokeVoteForTrack(std::ostream &out, std
 
 namespace commands::v1 {
 
-    void Vote::doExecute(const std::vector<std::string> &args) {
+    void Vote::doExecute(const Arguments &args) {
 
-        if (std::size(args) != 1) {
+        if (std::size(args) < 1 || std::size(args) > 2) {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_NUMBER);
         }
 
         auto api = api::v1::Api::getInstance();
 
-        const std::string dir {args[0]};
+        const auto dir {args[0]};
         if (dir != "up" && dir != "revoke") {
             throw ShellException(ShellExceptionCode::INVALID_ARGUMENT_VALUE);
         }
 
-        const auto queues {api->getCurrentQueues()};
+        const auto snapshot {api->getRecentQueues()};
+        const auto &queues {snapshot->queues};
+        QueueRenderer renderer;
+        renderer.renderSnapshotAge(*snapshot);
+        renderer.flush(getOut());
+
+        if (std::size(args) == 2) {
+            const auto &tracks {queues->normalQueue};
+            const auto selection {parseTrackSelection(args[1], std::size(tracks))};
+            const auto vote {dir == "up" ? api::v1::Vote::UP_VOTE : api::v1::Vote::DOWN_VOTE};
+            voteForTracks(getOut(), *api, tracks, selection, vote, args[1] != "all");
+            return;
+        }
+
         if (dir == "up") {
-            const auto optTrack {voteForTrack(getOut(), getIn(), queues.normalQueue)};
+            const auto optTrack {voteForTrack(getOut(), getIn(), queues->normalQueue)};
             if (!optTrack) {
                 return;
             }
@@ -148,7 +207,7 @@ namespace commands::v1 {
             api->voteTrack(track, api::v1::Vote::UP_VOTE);
             getOut() << fmt::format("Vote placed for track '{}' by '{}'.", track.title, track.artist) << std::endl;
         } else if (dir == "revoke") {
-            const auto optTrack {revokeVoteForTrack(getOut(), getIn(), queues.normalQueue)};
+            const auto optTrack {revokeVoteForTrack(getOut(), getIn(), queues->normalQueue)};
             if (!optTrack) {
                 return;
             }
@@ -162,9 +221,12 @@ namespace commands::v1 {
     ShellCommandDetails Vote::getCommandDetails() const {
         ShellCommandDetails details;
         details.description = "Vote for or track of the normal queue or revoke a vote for it.";
-        details.usage       = getTrigger() + " <dir>";
+        details.usage       = getTrigger() + " <dir> [<tracks>]";
         details.parameterDescription["<dir>"] =
             "Specify if the track is upvoted or downvoted. Valid values are: up/revoke. [Default: up]";
+        details.parameterDescription["<tracks>"] =
+            "Positions of the tracks in the normal queue, e.g. 1,3,5-9, or 'all'. The votes are sent concurrently. "
+            "Without it, the track is selected interactively.";
         return details;
     }
 
@@ -0,0 +1,119 @@
+/*****************************************************************************/
+/**
+ * @file    Histogram.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of a fixed-size log-linear histogram for latency percentiles
+ */
+/*****************************************************************************/
+
+#ifndef SK_HISTOGRAM_H
+#define SK_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+
+namespace sk {
+
+    //
+    // Records non-negative values (e.g. microseconds) into buckets whose width grows with the value.
+    // Values below SUB_BUCKET_COUNT are exact, larger ones have a relative error below 1/32.
+    // Recording never allocates; histograms of different threads can be merged afterwards.
+    //
+    class Histogram {
+    public:
+        void record(const uint64_t value) noexcept {
+            ++mCounts[indexOf(value)];
+            ++mCount;
+            mSum += value;
+            mMin = std::min(mMin, value);
+            mMax = std::max(mMax, value);
+        }
+
+        void merge(const Histogram &other) noexcept {
+            for (size_t i {0}; i < BUCKET_COUNT; ++i) {
+                mCounts[i] += other.mCounts[i];
+            }
+            mCount += other.mCount;
+            mSum += other.mSum;
+            mMin = std::min(mMin, other.mMin);
+            mMax = std::max(mMax, other.mMax);
+        }
+
+        void reset() noexcept { *this = Histogram(); }
+
+        uint64_t getCount() const noexcept { return mCount; }
+        uint64_t getSum() const noexcept { return mSum; }
+        uint64_t getMin() const noexcept { return mCount == 0 ? 0 : mMin; }
+        uint64_t getMax() const noexcept { return mMax; }
+        double getMean() const noexcept { return mCount == 0 ? 0.0 : double(mSum) / double(mCount); }
+
+        //
+        // Returns the smallest recorded bucket bound, below or at which the given percentage of values lies
+        //
+        uint64_t getPercentile(const double percentile) const noexcept {
+            if (mCount == 0) {
+                return 0;
+            }
+
+            const auto rank {
+                std::max<uint64_t>(1, uint64_t(std::clamp(percentile, 0.0, 100.0) / 100.0 * double(mCount) + 0.5))};
+
+            uint64_t seen {0};
+            for (size_t i {0}; i < BUCKET_COUNT; ++i) {
+                seen += mCounts[i];
+                if (seen >= rank) {
+                    return std::clamp(upperBoundOf(i), getMin(), mMax);
+                }
+            }
+            return mMax;
+        }
+
+    private:
+        static constexpr unsigned int SUB_BUCKET_BITS {6};
+        static constexpr size_t SUB_BUCKET_COUNT {size_t(1) << SUB_BUCKET_BITS};
+        static constexpr size_t SUB_BUCKET_HALF {SUB_BUCKET_COUNT / 2};
+        static constexpr size_t BUCKET_COUNT {SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * SUB_BUCKET_HALF};
+
+        static size_t indexOf(const uint64_t value) noexcept {
+            if (value < SUB_BUCKET_COUNT) {
+                return static_cast<unsigned int>(value);
+            }
+
+            unsigned int msb {SUB_BUCKET_BITS};
+            while (msb < 63 && (value >> (msb + 1)) != 0) {
+                ++msb;
+            }
+
+            // The top SUB_BUCKET_BITS bits of the value select the sub-bucket
+            const unsigned int shift {msb - SUB_BUCKET_BITS + 1};
+            const auto subBucket {static_cast<unsigned int>(value >> shift)};
+            return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF + (subBucket - SUB_BUCKET_HALF);
+        }
+
+        static uint64_t upperBoundOf(const size_t index) noexcept {
+            if (index < SUB_BUCKET_COUNT) {
+                return index;
+            }
+
+            const auto shift {static_cast<unsigned int>((index - SUB_BUCKET_COUNT) / SUB_BUCKET_HALF + 1)};
+            const uint64_t subBucket {(index - SUB_BUCKET_COUNT) % SUB_BUCKET_HALF + SUB_BUCKET_HALF};
+            if (subBucket + 1 > (std::numeric_limits<uint64_t>::max() >> shift)) {
+                return std::numeric_limits<uint64_t>::max();
+            }
+            return ((subBucket + 1) << shift) - 1;
+        }
+
+    private:
+        std::array<uint64_t, BUCKET_COUNT> mCounts {};
+        uint64_t mCount {0};
+        uint64_t mSum {0};
+        uint64_t mMin {std::numeric_limits<uint64_t>::max()};
+        uint64_t mMax {0};
+    };
+
+}  // namespace sk
+
+#endif /* SK_HISTOGRAM_H */
@@ -0,0 +1,123 @@
+/*****************************************************************************/
+/**
+ * @file    Tracer.cpp
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Implementation of an opt-in recorder for nested spans, exported as Chrome trace events
+ */
+/*****************************************************************************/
+
+#include "Tracer.h"
+
+#include <nlohmann/json.hpp>
+
+
+using json = nlohmann::json;
+using namespace sk;
+
+
+//
+// Helper functions
+//
+
+// Small sequential ids read better in trace viewers than hashed std::thread::ids
+static unsigned int getThreadId() {
+    static std::atomic<unsigned int> nextThreadId {1};
+    thread_local const unsigned int threadId {nextThreadId++};
+    return threadId;
+}
+
+
+//
+// Tracer
+//
+
+Tracer &Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+Tracer::~Tracer() { stop(); }
+
+bool Tracer::start(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    mFile.open(path, std::ios::out | std::ios::trunc);
+    if (!mFile) {
+        return false;
+    }
+
+    mOrigin = std::chrono::steady_clock::now();
+    mEvents.clear();
+    mEnabled = true;
+    return true;
+}
+
+void Tracer::stop() {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mEnabled) {
+        return;
+    }
+    mEnabled = false;
+
+    json events = json::array();
+    for (const auto &event : mEvents) {
+        json j {
+            {"name", event.name},             //
+            {"cat", event.category},          //
+            {"ph", "X"},                      //
+            {"ts", event.start.count()},      //
+            {"dur", event.duration.count()},  //
+            {"pid", 1},                       //
+            {"tid", event.threadId}           //
+        };
+        if (!event.detail.empty()) {
+            j["args"]["detail"] = event.detail;
+        }
+        events.push_back(std::move(j));
+    }
+
+    json trace;
+    trace["traceEvents"]     = std::move(events);
+    trace["displayTimeUnit"] = "ms";
+
+    // Details carry user input such as search patterns, which need not be valid UTF-8
+    mFile << trace.dump(-1, ' ', false, json::error_handler_t::replace) << std::endl;
+    mFile.close();
+    mEvents.clear();
+}
+
+void Tracer::recordSpan(const char *category, std::string name, std::string detail,
+                        const std::chrono::steady_clock::time_point start,
+                        const std::chrono::steady_clock::time_point end) {
+    const auto threadId {getThreadId()};
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (!mEnabled) {
+        return;
+    }
+
+    mEvents.push_back({category, std::move(name), std::move(detail),
+                       std::chrono::duration_cast<std::chrono::microseconds>(start - mOrigin),
+                       std::chrono::duration_cast<std::chrono::microseconds>(end - start), threadId});
+}
+
+
+//
+// TraceSpan
+//
+
+TraceSpan::TraceSpan(const char *category, std::string_view name, std::string_view detail)
+    : mActive(Tracer::getInstance().isEnabled()), mCategory(category) {
+    if (mActive) {
+        mName   = name;
+        mDetail = detail;
+        mStart  = std::chrono::steady_clock::now();
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (mActive) {
+        Tracer::getInstance().recordSpan(mCategory, std::move(mName), std::move(mDetail), mStart,
+                                         std::chrono::steady_clock::now());
+    }
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************/
+/**
+ * @file    Tracer.h
+ * @author  Sebastian Kaupper <kauppersebastian@gmail.com>
+ * @brief   Definition of an opt-in recorder for nested spans, exported as Chrome trace events
+ */
+/*****************************************************************************/
+
+#ifndef SK_TRACER_H
+#define SK_TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace sk {
+
+    class Tracer {
+    public:
+        static Tracer &getInstance();
+
+        ~Tracer();
+
+        //
+        // Starts recording spans, which are written to the given file once tracing stops.
+        // The file can be opened in chrome://tracing or ui.perfetto.dev.
+        // Returns false if the file cannot be written.
+        //
+        bool start(const std::string &path);
+        void stop();
+
+        bool isEnabled() const noexcept { return mEnabled.load(std::memory_order_relaxed); }
+
+        void recordSpan(const char *category, std::string name, std::string detail,
+                        const std::chrono::steady_clock::time_point start,
+                        const std::chrono::steady_clock::time_point end);
+
+    private:
+        Tracer() = default;
+
+        struct Event {
+            const char *category;
+            std::string name;
+            std::string detail;
+            std::chrono::microseconds start;
+            std::chrono::microseconds duration;
+            unsigned int threadId;
+        };
+
+        std::atomic_bool mEnabled {false};
+
+        std::mutex mMutex;
+        std::ofstream mFile;
+        std::chrono::steady_clock::time_point mOrigin;
+        std::vector<Event> mEvents;
+    };
+
+
+    //
+    // Records the time between its construction and destruction as a span of the current thread.
+    // Spans nest by time, so a span created while another one is alive shows up as its child.
+    // Does nothing (and copies nothing) while tracing is disabled.
+    //
+    class TraceSpan {
+    public:
+        TraceSpan(const char *category, std::string_view name, std::string_view detail = {});
+        ~TraceSpan();
+
+        TraceSpan(const TraceSpan &) = delete;
+        TraceSpan &operator=(const TraceSpan &) = delete;
+
+    private:
+        bool mActive;
+        const char *mCategory;
+        std::string mName;
+        std::string mDetail;
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+}  // namespace sk
+
+#endif /* SK_TRACER_H */
@@ -12,6 +12,7 @@
 namespace sk {
     enum class HttpStatus {
         OK           = 200,
+        NOT_MODIFIED = 304,
         NOT_FOUND    = 400,
         UNAUTHORIZED = 401,
         // TODO
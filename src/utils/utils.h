@@ -2,49 +2,28 @@
 #define SK_UTILS_H
 
 
+#include <charconv>
 #include <optional>
 #include <ostream>
-#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <system_error>
 
 #include <fmt/format.h>
 
 
 namespace sk {
 
+    //
+    // Parses a decimal number, which has to span the whole string and fit into T
+    //
     template<typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
-    std::optional<T> to_number(const std::string &valStr) {
-        T valNum;
-        size_t idx;
+    std::optional<T> to_number(const std::string_view valStr) {
+        T valNum {};
 
-        try {
-            // Use the most appropriate conversion function for the type T
-            if constexpr (sizeof(T) <= sizeof(int)) {
-                if constexpr (std::is_signed_v<T>) {
-                    valNum = std::stoi(valStr, &idx);
-                } else {
-                    valNum = std::stoul(valStr, &idx);
-                }
-            } else {
-                if constexpr (std::is_signed_v<T>) {
-                    valNum = std::stoll(valStr, &idx);
-                } else {
-                    valNum = std::stoull(valStr, &idx);
-                }
-            }
-
-            // For unsigned types of T make sure the string does not contain a negative number
-            if constexpr (std::is_unsigned_v<T>) {
-                if (!valStr.empty() && valStr[0] == '-') {
-                    return std::nullopt;
-                }
-            }
-        } catch (const std::invalid_argument &) {
-            return std::nullopt;
-        }
-
-        // Make sure that the whole string got processed
-        if (idx != valStr.size()) {
+        const auto last {valStr.data() + valStr.size()};
+        const auto [ptr, ec] {std::from_chars(valStr.data(), last, valNum)};
+        if (ec != std::errc() || ptr != last) {
             return std::nullopt;
         }
         return valNum;
@@ -66,7 +45,7 @@ std::ostream &operator<<(std::ostream &out, const std::optional<T> &option) {
 template<typename T>
 struct fmt::formatter<std::optional<T>> : formatter<T> {
     template<typename FormatContext>
-    auto format(std::optional<T> opt, FormatContext &ctx) {
+    auto format(const std::optional<T> &opt, FormatContext &ctx) {
         if (opt) {
             return formatter<T>::format(opt.value(), ctx);
         } else {